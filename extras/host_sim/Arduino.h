@@ -0,0 +1,54 @@
+/**
+    \file       Arduino.h
+    \brief      Minimal emulation of the Arduino ATMega core to run the task scheduler on a host PC
+    \details    Only provides what Tasks.cpp uses. Timer 0 and the global interrupt flag are emulated by sim.cpp,
+                i.e. time only advances via Sim_Run(), and TIMER0_COMPA_vect() is called at each compare match
+                while interrupts are enabled. Like on the ATMega it is called nested if a task enables interrupts.
+*/
+
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+
+// emulated controller
+#define __AVR__             1
+#define F_CPU               16000000UL
+
+
+// status register. Only the global interrupt flag is used, writing it may trigger a pending interrupt
+#define SREG_I              0x80
+class Sim_StatusRegister
+{
+    public:
+        operator uint8_t() const;
+        Sim_StatusRegister& operator=(uint8_t value);
+};
+extern Sim_StatusRegister SREG;
+
+void noInterrupts(void);
+void interrupts(void);
+#define ISR(vector)         extern "C" void vector(void)
+
+
+// timer 0 with 4us resolution (prescaler 64 at 16MHz)
+#define TCNT0               Sim_TCNT0()
+#define OCF0A               1
+#define OCIE0A              1
+uint8_t Sim_TCNT0(void);
+extern volatile uint8_t OCR0A;
+extern volatile uint8_t TIFR0;
+extern volatile uint8_t TIMSK0;
+
+
+// misc Arduino API
+#define OUTPUT              1
+#define B00000010           0x02
+extern volatile uint8_t PORTB;
+void pinMode(uint8_t pin, uint8_t mode);
+unsigned long millis(void);
+unsigned long micros(void);
+
+#endif // ARDUINO_H
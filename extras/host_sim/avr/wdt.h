@@ -0,0 +1,15 @@
+/**
+    \file       wdt.h
+    \brief      Watchdog emulation for the host simulation, see Arduino.h
+*/
+
+#ifndef WDT_H
+#define WDT_H
+
+#include <stdint.h>
+
+#define WDTO_15MS           0
+
+void wdt_enable(uint8_t timeout);
+
+#endif // WDT_H
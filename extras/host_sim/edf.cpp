@@ -0,0 +1,114 @@
+/**
+    \file       edf.cpp
+    \brief      Host simulation: deadline misses of EDF vs. index dispatch
+    \details    Random task sets with a CPU utilization of 80-95% are executed once in index mode and once in
+                EDF mode, see Tasks_SetMode(). The tasks are added in random order and their deadline is the
+                period. A task misses its deadline if it finishes later than one period after its release.
+                EDF must not miss more deadlines than index dispatch.
+*/
+
+#include <stdio.h>
+#include "Tasks.h"
+#include "sim.h"
+
+
+#define NUM_SETS    50
+#define NUM_TICKS   2000
+#define MAX_TASKS   6
+
+const int16_t   periods[] = { 2, 3, 4, 5, 8, 10, 20 };
+
+uint8_t     numtasks;
+int16_t     period[MAX_TASKS];
+uint32_t    runtime[MAX_TASKS];     // CPU time in us
+uint32_t    executions, misses;
+
+
+// reproducible pseudo random numbers
+uint32_t    seed = 1;
+uint16_t random16(void)
+{
+    seed = seed * 1103515245UL + 12345;
+    return (uint16_t) (seed >> 16);
+}
+
+
+// task i uses its CPU time and checks its deadline
+template <uint8_t I> void task(void)
+{
+    Sim_Run(runtime[I]);
+    executions++;
+    if (Tasks_Latency() > ((uint32_t) period[I] << 16))
+        misses++;
+}
+
+Task        tasks[MAX_TASKS] = { task<0>, task<1>, task<2>, task<3>, task<4>, task<5> };
+
+
+// execute current task set in given mode, return number of deadline misses
+uint32_t run_set(uint8_t mode)
+{
+    Tasks_Clear();
+    for (uint8_t i = 0; i < numtasks; i++)
+        Tasks_Add(tasks[i], period[i], 0);
+    #if (TASKS_USE_EDF)
+        Tasks_SetMode(mode);
+    #else
+        (void) mode;
+    #endif
+
+    executions = 0;
+    misses = 0;
+    Tasks_Start();
+    Sim_Wait(NUM_TICKS * SIM_TICK_US);
+    Tasks_Pause();
+
+    return misses;
+}
+
+
+
+int main(void)
+{
+    char        text[80];
+    uint32_t    missindex = 0, missedf = 0, total = 0;
+    uint8_t     worse = 0;
+
+    #if !(TASKS_USE_EDF)
+        printf("skipped, TASKS_USE_EDF is set to 0\n");
+        return 0;
+    #endif
+
+    Tasks_Init();
+    for (uint8_t set = 0; set < NUM_SETS; set++)
+    {
+        // random periods in random order
+        numtasks = 3 + random16() % (MAX_TASKS - 2);
+        for (uint8_t i = 0; i < numtasks; i++)
+            period[i] = periods[random16() % (sizeof(periods) / sizeof(periods[0]))];
+
+        // split random utilization of 80-95% randomly between tasks
+        uint16_t weight[MAX_TASKS], sum = 0;
+        uint16_t load = 800 + random16() % 151;
+        for (uint8_t i = 0; i < numtasks; i++)
+            sum += (weight[i] = 1 + random16() % 100);
+        for (uint8_t i = 0; i < numtasks; i++)
+            runtime[i] = ((uint32_t) load * weight[i] / sum) * period[i] * SIM_TICK_US / 1000;
+
+        uint32_t index = run_set(TASKS_MODE_INDEX);
+        total += executions;
+        uint32_t edf = run_set(TASKS_MODE_EDF);
+        missindex += index;
+        missedf += edf;
+        if (edf > index)
+            worse++;
+    }
+
+    printf("%d task sets, %lu executions per mode\n", NUM_SETS, (unsigned long) total);
+    sprintf(text, "deadline misses: index %lu, EDF %lu", (unsigned long) missindex, (unsigned long) missedf);
+    Sim_Check(missedf <= missindex, text);
+    sprintf(text, "%d task sets with more misses in EDF mode", worse);
+    Sim_Check(worse == 0, text);
+
+    return Sim_GetFailed();
+}
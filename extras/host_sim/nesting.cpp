@@ -0,0 +1,64 @@
+/**
+    \file       nesting.cpp
+    \brief      Host simulation: nesting depth of the scheduler under overload
+    \details    Six tasks with periods of 1..6 ticks each need 2 ticks of CPU time, i.e. the CPU is heavily
+                overloaded. The reentrant scheduler interrupt of the ATMega starts due tasks on top of the running
+                ones. Tasks_SetMaxNesting() must keep the depth at the limit, while all tasks are still executed.
+*/
+
+#include <stdio.h>
+#include "Tasks.h"
+#include "sim.h"
+
+
+#define NUM_TASKS   6
+#define LIMIT       3
+
+uint16_t    count[NUM_TASKS];
+
+
+// task i needs 2 ticks of CPU time
+template <uint8_t I> void task(void)
+{
+    count[I]++;
+    Sim_Run(2 * SIM_TICK_US);
+}
+
+Task        tasks[NUM_TASKS] = { task<0>, task<1>, task<2>, task<3>, task<4>, task<5> };
+
+
+
+int main(void)
+{
+    char    text[80];
+
+    Tasks_Init();
+    for (uint8_t i = 0; i < NUM_TASKS; i++)
+        Tasks_Add(tasks[i], i + 1, 0);
+
+    // limited nesting depth
+    printf("overload with max. nesting depth %d\n", LIMIT);
+    Tasks_SetMaxNesting(LIMIT);
+    Tasks_Start();
+    Sim_Wait(1000 * SIM_TICK_US);
+    sprintf(text, "peak nesting depth %d equals limit", Tasks_GetPeakNesting());
+    Sim_Check(Tasks_GetPeakNesting() == LIMIT, text);
+    sprintf(text, "%u ticks skipped", Tasks_GetSkippedTicks());
+    Sim_Check(Tasks_GetSkippedTicks() > 0, text);
+    for (uint8_t i = 0; i < NUM_TASKS; i++)
+    {
+        sprintf(text, "task %d (period %d) executed %u times", i, i + 1, count[i]);
+        Sim_Check(count[i] > 0, text);
+    }
+
+    // unlimited nesting depth. Only bounded by number of tasks, as a running task is not started again. One more
+    // level is entered by a tick which finds all due tasks running
+    printf("overload without limit\n");
+    Tasks_SetMaxNesting(0);
+    Sim_Wait(1000 * SIM_TICK_US);
+    sprintf(text, "peak nesting depth %d above limit", Tasks_GetPeakNesting());
+    Sim_Check((Tasks_GetPeakNesting() > LIMIT) && (Tasks_GetPeakNesting() <= NUM_TASKS + 1), text);
+
+    Tasks_Pause();
+    return Sim_GetFailed();
+}
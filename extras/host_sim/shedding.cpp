@@ -0,0 +1,113 @@
+/**
+    \file       shedding.cpp
+    \brief      Host simulation: load measurement and load shedding
+    \details    First a single task uses a known share of each tick, which Tasks_GetLoad() must report. Then a
+                critical and a non-critical task overload the CPU. Load shedding must stretch the period of the
+                non-critical task, while the critical task keeps its period and deadline. When the load of the
+                non-critical task drops, its period must be restored, see Tasks_SetShedding().
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "Tasks.h"
+#include "sim.h"
+
+
+#if !(TASKS_USE_SHEDDING)
+
+int main(void)
+{
+    printf("skipped, TASKS_USE_SHEDDING is set to 0\n");
+    return 0;
+}
+
+#else
+
+#define WINDOW      100     // ticks per load measurement
+
+uint32_t    runtime[2];     // CPU time in us
+uint16_t    count[2];       // executions in current window
+uint16_t    misses;         // deadline misses of critical task
+
+
+// task uses its CPU time
+void measured(void)
+{
+    Sim_Run(runtime[0]);
+}
+
+// critical task with period 2 checks its deadline
+void critical(void)
+{
+    Sim_Run(runtime[0]);
+    count[0]++;
+    if (Tasks_Latency() > (2UL << 16))
+        misses++;
+}
+
+// non-critical task which may be stretched
+void optional(void)
+{
+    Sim_Run(runtime[1]);
+    count[1]++;
+}
+
+
+// run for some windows and count executions in the last one
+void run_windows(uint8_t windows)
+{
+    Sim_Wait((windows - 1) * WINDOW * SIM_TICK_US);
+    count[0] = count[1] = 0;
+    Sim_Wait(WINDOW * SIM_TICK_US);
+}
+
+
+
+int main(void)
+{
+    char    text[80];
+
+    // load measurement. Task finishes within its tick, i.e. the scheduler never interrupts it
+    Tasks_Init();
+    Tasks_Add(measured, 1, 0);
+    Tasks_SetShedding(101, 0, 0);
+    Tasks_Start();
+    const uint8_t loads[] = { 95, 50, 5 };
+    for (uint8_t load : loads)
+    {
+        runtime[0] = load * SIM_TICK_US / 100;
+        run_windows(3);
+        sprintf(text, "task with %d%% load measured as %d%%", load, Tasks_GetLoad());
+        Sim_Check(abs(Tasks_GetLoad() - load) <= 2, text);
+    }
+    Tasks_Pause();
+
+    // overload by 30% critical and 80% non-critical load. Without shedding the non-critical task already misses
+    // releases, i.e. the load settles at about 85%
+    printf("overload, shedding above 80%% and restore below 50%%\n");
+    Tasks_Clear();
+    Tasks_Add(critical, 2, 0);
+    Tasks_Add(optional, 2, 1);
+    Tasks_SetPeriodRange(optional, 2, 32, 0);
+    Tasks_SetShedding(80, 50, 1);
+    runtime[0] = 6 * SIM_TICK_US / 10;
+    runtime[1] = 16 * SIM_TICK_US / 10;
+    Tasks_Start();
+    run_windows(10);
+    sprintf(text, "load %d%%, non-critical task stretched to %d executions per %d ticks", Tasks_GetLoad(), count[1], WINDOW);
+    Sim_Check((count[1] <= WINDOW / 4 + 1) && (Tasks_GetLoad() < 80), text);
+    sprintf(text, "critical task executed %d times per %d ticks, %d deadline misses", count[0], WINDOW, misses);
+    Sim_Check((count[0] >= WINDOW / 2 - 1) && (misses == 0), text);
+
+    // low load -> restore period
+    printf("low load\n");
+    runtime[1] = 2 * SIM_TICK_US / 10;
+    run_windows(10);
+    sprintf(text, "load %d%%, non-critical task restored to %d executions per %d ticks", Tasks_GetLoad(), count[1], WINDOW);
+    Sim_Check(count[1] >= WINDOW / 2 - 1, text);
+    Tasks_Pause();
+
+    return Sim_GetFailed();
+}
+
+#endif // TASKS_USE_SHEDDING
@@ -0,0 +1,177 @@
+/**
+    \file       sim.cpp
+    \brief      Emulation of the Arduino ATMega core and time base of the host simulation
+    \details    For more details please refer to Arduino.h and sim.h
+*/
+
+#include <stdio.h>
+#include "Arduino.h"
+#include "avr/wdt.h"
+#include "sim.h"
+
+
+// scheduler interrupt in Tasks.cpp
+extern "C" void TIMER0_COMPA_vect(void);
+
+
+// emulated registers
+Sim_StatusRegister SREG;
+volatile uint8_t OCR0A;
+volatile uint8_t TIFR0;
+volatile uint8_t TIMSK0;
+volatile uint8_t PORTB;
+
+
+// start of heap for Tasks_PaintStack(). Painting is not supported on the host, i.e. do not call it
+uint8_t __heap_start;
+void    *__brkval;
+
+
+// simulation state
+uint32_t _simclock;                 // timer 0 clocks of 4us since start
+bool     _siminterrupts = true;     // global interrupt flag (enabled by Arduino core before setup())
+uint16_t _simresets;                // number of watchdog resets
+int      _simfailed;                // number of failed checks
+
+
+
+// execute pending scheduler interrupt. Like on the ATMega interrupts are disabled on entry and enabled by RETI
+void Sim_dispatch(void)
+{
+    while (_siminterrupts && (TIFR0 & (1 << OCF0A)) && (TIMSK0 & (1 << OCIE0A)))
+    {
+        TIFR0 &= ~(1 << OCF0A);
+        _siminterrupts = false;
+        TIMER0_COMPA_vect();
+        _siminterrupts = true;
+    }
+
+} // Sim_dispatch()
+
+
+
+Sim_StatusRegister::operator uint8_t() const
+{
+    return _siminterrupts ? SREG_I : 0;
+
+} // Sim_StatusRegister::operator uint8_t()
+
+
+
+Sim_StatusRegister& Sim_StatusRegister::operator=(uint8_t value)
+{
+    _siminterrupts = (value & SREG_I) != 0;
+    Sim_dispatch();
+    return *this;
+
+} // Sim_StatusRegister::operator=()
+
+
+
+void noInterrupts(void)
+{
+    _siminterrupts = false;
+
+} // noInterrupts()
+
+
+
+void interrupts(void)
+{
+    _siminterrupts = true;
+    Sim_dispatch();
+
+} // interrupts()
+
+
+
+uint8_t Sim_TCNT0(void)
+{
+    return (uint8_t) _simclock;
+
+} // Sim_TCNT0()
+
+
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    (void) pin;
+    (void) mode;
+
+} // pinMode()
+
+
+
+unsigned long millis(void)
+{
+    return (_simclock * 4) / 1000;
+
+} // millis()
+
+
+
+unsigned long micros(void)
+{
+    return _simclock * 4;
+
+} // micros()
+
+
+
+void wdt_enable(uint8_t timeout)
+{
+    (void) timeout;
+    _simresets++;
+
+} // wdt_enable()
+
+
+
+void Sim_Run(uint32_t us)
+{
+    for (uint32_t n = (us + 3) / 4; n > 0; n--)
+    {
+        _simclock++;
+        if ((uint8_t) _simclock == OCR0A)
+            TIFR0 |= (1 << OCF0A);
+        Sim_dispatch();
+    }
+
+} // Sim_Run()
+
+
+
+void Sim_Wait(uint32_t us)
+{
+    uint32_t end = _simclock + (us + 3) / 4;
+
+    while ((int32_t) (end - _simclock) > 0)
+        Sim_Run(4);
+
+} // Sim_Wait()
+
+
+
+uint16_t Sim_GetWatchdogResets(void)
+{
+    return _simresets;
+
+} // Sim_GetWatchdogResets()
+
+
+
+void Sim_Check(bool ok, const char *text)
+{
+    printf("%s %s\n", ok ? "  ok    " : "  FAILED", text);
+    if (!ok)
+        _simfailed++;
+
+} // Sim_Check()
+
+
+
+int Sim_GetFailed(void)
+{
+    return _simfailed;
+
+} // Sim_GetFailed()
@@ -0,0 +1,52 @@
+/**
+    \file       sim.h
+    \brief      Time base and checks of the host simulation, see Arduino.h
+    \details    The simulation has no real time. The main loop and the tasks consume CPU time via Sim_Run(),
+                which advances timer 0 and calls the scheduler interrupt at each compare match, i.e. every
+                1.024ms. Tasks and scheduler code without Sim_Run() take no time.
+*/
+
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+
+
+#define SIM_TICK_US         1024UL      //!< Duration of scheduler tick in us
+
+/**
+    \brief      Consume CPU time in the current context
+    \details    Advances timer 0 in steps of 4us. If interrupts are enabled, the scheduler interrupt is called
+                at each compare match, else it stays pending until interrupts are enabled.
+    \param[in]  us      CPU time in us
+*/
+void Sim_Run(uint32_t us);
+
+/**
+    \brief      Let time pass in the main loop
+    \details    Advances timer 0 like Sim_Run() until the given time has passed, independent of the CPU time
+                used by the scheduler interrupt and the tasks in between. Must not be called from a task.
+    \param[in]  us      time in us
+*/
+void Sim_Wait(uint32_t us);
+
+/**
+    \brief      Get number of watchdog resets requested by the scheduler
+    \return     number of calls of wdt_enable()
+*/
+uint16_t Sim_GetWatchdogResets(void);
+
+/**
+    \brief      Print and count the result of a check
+    \param[in]  ok      check passed
+    \param[in]  text    description of check
+*/
+void Sim_Check(bool ok, const char *text);
+
+/**
+    \brief      Get number of failed checks, e.g. as return value of main()
+    \return     number of failed checks
+*/
+int Sim_GetFailed(void);
+
+#endif // SIM_H
@@ -5,6 +5,9 @@
 */
 
 #include "Tasks.h"
+#if defined(__AVR__)
+    #include <avr/wdt.h>
+#endif
 
 
 // check Arduino controller only once
@@ -28,33 +31,186 @@
 
 
 // macro to pause / resume interrupt (interrupts are only reactivated in case they have been active in the beginning)
-uint8_t oldISR = 0;
+// The old state is kept in a local variable of the calling scope. A shared global would be overwritten by a task
+// or nested scheduler call that pauses interrupts in between, and critical sections could not be nested.
 #if defined(__AVR__)
-	#define PAUSE_INTERRUPTS    { oldISR = SREG; noInterrupts(); }
-	#define RESUME_INTERRUPTS   { SREG = oldISR; interrupts();     }
+	#define PAUSE_INTERRUPTS    uint8_t oldISR = SREG; noInterrupts()
+	#define RESUME_INTERRUPTS   SREG = oldISR
 #elif defined(__SAM3X8E__)
-	#define PAUSE_INTERRUPTS    { oldISR = ((__get_PRIMASK() & 0x1) == 0 && (__get_FAULTMASK() & 0x1) == 0); noInterrupts(); }
-	#define RESUME_INTERRUPTS   { if (oldISR != 0) { interrupts(); } }
+	#define PAUSE_INTERRUPTS    uint8_t oldISR = ((__get_PRIMASK() & 0x1) == 0 && (__get_FAULTMASK() & 0x1) == 0); noInterrupts()
+	#define RESUME_INTERRUPTS   do { if (oldISR != 0) { interrupts(); } } while (0)
 #endif
 
 
-// task container
-struct SchedulingStruct
-{
-    Task    func;       // function to call
-    bool    active;     // task is active
-    bool    running;    // task is currently being executed
-    int16_t period;     // period of task (0 = call only once)
-    int16_t time;       // time of next call
-};
+// task table as structure of arrays. The 'active' and 'running' flags are stored as bitmasks, which allows
+// the scheduler to skip a complete word of inactive or running tasks with a single check
+#define TASK_WORD(i)    ((i) / TASKS_MASK_BITS)                             // index of bitmask word containing task
+#define TASK_BIT(i)     ((TasksMask_t) 1 << ((i) % TASKS_MASK_BITS))       // bit of task within bitmask word
+
+
+// internal task flags (lower bits contain TASKS_OVERRUN_xxx action)
+#define TASK_FLAG_OVERRUN   0x80    // overrun of current execution was already reported
+#define TASK_FLAG_JOINED    0x40    // task has finished, but its successor still waits for other predecessors
+#define TASK_FLAG_PARKED    0x20    // successor without period waits for release by its predecessors
+#define TASK_FLAG_PAUSED    0x10    // task was paused by the application, i.e. a release must not activate it
+
+
+// pattern for stack painting, see Tasks_PaintStack()
+#define STACK_PATTERN       0xA5
+#define STACK_MARGIN        32      // bytes below current stack pointer which are not painted
+#define STACK_CHUNK         64      // bytes painted per interrupt lock
+
+
+// number of ticks per load measurement, see Tasks_GetLoad()
+#define LOAD_WINDOW         100
+
+
+// start of free RAM between heap and stack
+#if defined(__AVR__)
+    extern uint8_t __heap_start;
+    extern void *__brkval;
+    #define FREE_RAM_START  ((uint8_t*) ((__brkval == NULL) ? (void*) &__heap_start : __brkval))
+#elif defined(__SAM3X8E__)
+    extern "C" char *sbrk(int incr);
+    #define FREE_RAM_START  ((uint8_t*) sbrk(0))
+#endif
+
+
+// time base for budget supervision. On SAM the scheduler interrupt cannot nest, i.e. _timebase is not
+// incremented while a task is hanging. Therefore use the SysTick counter instead
+#if defined(__AVR__)
+    #define SUPERVISION_TIME    (_timebase)
+#elif defined(__SAM3X8E__)
+    #define SUPERVISION_TIME    ((int16_t) millis())
+#endif
+
+
+// task flags array is shared by budget supervision and task chains
+#define TASK_USE_FLAGS      (TASKS_USE_BUDGET || TASKS_USE_CHAINS)
+
+
+// task table layout. All arrays are located in the storage passed to Tasks_Init() and only its start and the
+// number of slots are stored. Arrays are ordered by alignment, byte offsets for n slots are given by OFS_xxx(n).
+// Arrays of disabled features have size 0, see TASKS_USE_xxx
+#define TABLE_SIZE(use, n, type)    ((use) ? (n) * sizeof(type) : 0)
+#define OFS_RUNNING(n)      (TASKS_MASK_WORDS(n) * sizeof(TasksMask_t))
+#define OFS_FUNC(n)         (OFS_RUNNING(n) + TASKS_MASK_WORDS(n) * sizeof(TasksMask_t))
+#define OFS_PERIOD(n)       (OFS_FUNC(n) + (n) * sizeof(Task))
+#define OFS_TIME(n)         (OFS_PERIOD(n) + (n) * sizeof(int16_t))
+#define OFS_DEADLINE(n)     (OFS_TIME(n) + (n) * sizeof(int16_t))
+#define OFS_MINPERIOD(n)    (OFS_DEADLINE(n) + TABLE_SIZE(TASKS_USE_EDF, n, int16_t))
+#define OFS_MAXPERIOD(n)    (OFS_MINPERIOD(n) + TABLE_SIZE(TASKS_USE_SHEDDING, n, int16_t))
+#define OFS_BUDGET(n)       (OFS_MAXPERIOD(n) + TABLE_SIZE(TASKS_USE_SHEDDING, n, int16_t))
+#define OFS_START(n)        (OFS_BUDGET(n) + TABLE_SIZE(TASKS_USE_BUDGET, n, int16_t))
+#define OFS_OVERRUN(n)      (OFS_START(n) + TABLE_SIZE(TASKS_USE_BUDGET, n, int16_t))
+#define OFS_FLAGS(n)        (OFS_OVERRUN(n) + TABLE_SIZE(TASKS_USE_BUDGET, n, uint8_t))
+#define OFS_GROUP(n)        (OFS_FLAGS(n) + TABLE_SIZE(TASK_USE_FLAGS, n, uint8_t))
+#define OFS_SUCC(n)         (OFS_GROUP(n) + TABLE_SIZE(TASKS_USE_GROUPS, n, uint8_t))
+#define OFS_JOIN(n)         (OFS_SUCC(n) + TABLE_SIZE(TASKS_USE_CHAINS, n, uint8_t))
+#define OFS_JOINLEFT(n)     (OFS_JOIN(n) + TABLE_SIZE(TASKS_USE_CHAINS, n, uint8_t))
+#define OFS_CRITICALITY(n)  (OFS_JOINLEFT(n) + TABLE_SIZE(TASKS_USE_CHAINS, n, uint8_t))
+#define OFS_END(n)          (OFS_CRITICALITY(n) + TABLE_SIZE(TASKS_USE_SHEDDING, n, uint8_t))
+
+// the layout must fill exactly the storage size reported by TASKS_BUFFER_WORDS(). Offsets grow linearly
+// with n, thus checking a few values covers all
+#define LAYOUT_OK(n)        ((OFS_END(n) + sizeof(TasksMask_t) - 1) / sizeof(TasksMask_t) == TASKS_BUFFER_WORDS(n))
+static_assert(LAYOUT_OK(1) && LAYOUT_OK(2) && LAYOUT_OK(MAX_TASK_CNT) && LAYOUT_OK(255),
+              "TASKS_BUFFER_WORDS() does not match task table layout");
+
+// access task table arrays. Arrays of disabled features are not defined
+#define TABLE(ofs, type)    ((type*) ((uint8_t*) _activemask + ofs(_taskcnt)))
+#define _runningmask            TABLE(OFS_RUNNING, TasksMask_t)     // task is currently being executed
+#define SchedulingFunc          TABLE(OFS_FUNC, Task)               // function to call (NULL = free slot)
+#define SchedulingPeriod        TABLE(OFS_PERIOD, int16_t)          // period of task (0 = call only once)
+#define SchedulingTime          TABLE(OFS_TIME, int16_t)            // time of next call
+#if (TASKS_USE_EDF)
+    #define SchedulingDeadline      TABLE(OFS_DEADLINE, int16_t)        // relative deadline of task (0 = period), see TASKS_MODE_EDF
+#endif
+#if (TASKS_USE_SHEDDING)
+    #define SchedulingMinPeriod     TABLE(OFS_MINPERIOD, int16_t)       // period of task at low load, see Tasks_SetPeriodRange()
+    #define SchedulingMaxPeriod     TABLE(OFS_MAXPERIOD, int16_t)       // max. period of task at high load (0 = period not adapted)
+    #define SchedulingCriticality   TABLE(OFS_CRITICALITY, uint8_t)     // tasks below _shedcrit are stretched under overload
+#endif
+#if (TASKS_USE_BUDGET)
+    #define SchedulingBudget        TABLE(OFS_BUDGET, int16_t)          // max. execution time of task (0 = no supervision)
+    #define SchedulingStart         TABLE(OFS_START, int16_t)           // start time of current execution (see SUPERVISION_TIME)
+    #define SchedulingOverrun       TABLE(OFS_OVERRUN, uint8_t)         // number of budget overruns
+#endif
+#if (TASK_USE_FLAGS)
+    #define SchedulingFlags         TABLE(OFS_FLAGS, uint8_t)           // overrun action and internal flags (see TASK_FLAG_xxx)
+#endif
+#if (TASKS_USE_GROUPS)
+    #define SchedulingGroup         TABLE(OFS_GROUP, uint8_t)           // bitmask of groups the task belongs to (0 = no group)
+#endif
+#if (TASKS_USE_CHAINS)
+    #define SchedulingSucc          TABLE(OFS_SUCC, uint8_t)            // slot of successor task released after execution (0xFF = none)
+    #define SchedulingJoin          TABLE(OFS_JOIN, uint8_t)            // number of predecessor tasks (0 = task is no successor)
+    #define SchedulingJoinLeft      TABLE(OFS_JOINLEFT, uint8_t)        // number of predecessors which still have to finish before release
+#endif
 
 
 // global variables for scheduler
-struct SchedulingStruct SchedulingTable[MAX_TASK_CNT] = { {(Task)NULL, false, false, 0, 0} }; // array containing all tasks
+TasksMask_t *_activemask;   // task is active (only set for used slots). Start of task table, see TABLE()
+#if (TASKS_USE_BUDGET)
+    TaskOverrunHook _overrunhook;   // function to call on budget overrun
+    bool     _budgetused;       // a budget was set, i.e. running tasks are supervised (see Tasks_SetBudget())
+    #define STATE_BUDGET    (sizeof(_overrunhook) + sizeof(_budgetused))
+#else
+    #define STATE_BUDGET    0
+#endif
+uint8_t  _nesting;          // current nesting depth of scheduler interrupt (0 = no task running)
+uint8_t  _maxnesting;       // max. allowed nesting depth (0 = unlimited)
+uint8_t  _peaknesting;      // max. nesting depth reached so far
+uint16_t _skippedticks;     // number of ticks without task dispatch due to _maxnesting
+#if (TASKS_USE_SHEDDING)
+    uint8_t  _loadticks;        // ticks in current load measurement window
+    uint32_t _busytime;         // time with a running task in current window (Tasks_Now() units)
+    uint32_t _busystart;        // start of not yet counted busy time (Tasks_Now() units)
+    uint8_t  _load;             // CPU load of last window in %
+    uint8_t  _shedhigh;         // load in % above which non-critical tasks are stretched (0 = no load shedding)
+    uint8_t  _shedlow;          // load in % below which stretched tasks are restored
+    uint8_t  _shedcrit;         // tasks with lower criticality are stretched
+    #define STATE_SHEDDING  (sizeof(_loadticks) + sizeof(_busytime) + sizeof(_busystart) + sizeof(_load) + sizeof(_shedhigh) + sizeof(_shedlow) + sizeof(_shedcrit))
+#else
+    #define STATE_SHEDDING  0
+#endif
+volatile uint8_t _timeseq;  // incremented with each update of _timebase, see Tasks_Now()
+#if defined(__SAM3X8E__)
+    uint32_t _tickmicros;   // micros() at start of the tick counted last, see Tasks_Now()
+    #define STATE_HW        sizeof(_tickmicros)
+#else
+    #define STATE_HW        0
+#endif
+uint8_t  _currenttask;      // slot of currently executing task (0xFF = none)
+int16_t  _currentrelease;   // release time of currently executing task
+#if (TASKS_USE_EDF)
+    int16_t  _currentdeadline;  // absolute deadline of currently executing task
+    uint8_t  _schedulingmode;   // dispatch order of due tasks (see TASKS_MODE_xxx)
+    #define STATE_EDF       (sizeof(_currentdeadline) + sizeof(_schedulingmode))
+#else
+    #define STATE_EDF       0
+#endif
 bool    SchedulingActive;   // false = Scheduling stopped, true = Scheduling active (no configuration allowed)
 int16_t _timebase;          // 1ms counter (on ATMega 1.024ms, is compensated)
 int16_t _nexttime;          // time of next task call 
-uint8_t _lasttask;          // last task in the tasks array (cauting! This variable starts is not counting from 0 to x but from 1 to x meaning that a single tasks will be at SchedulingTable[0] but _lasttask will have the value '1')
+uint8_t _lasttask;          // last task in the tasks array (cauting! This variable starts is not counting from 0 to x but from 1 to x meaning that a single tasks will be at SchedulingFunc[0] but _lasttask will have the value '1')
+uint8_t _taskcnt;           // number of slots in task table (0 = Tasks_Init() not yet called)
+#if (TASKS_USE_BACKGROUND)
+    TaskStep _bgstep[MAX_BACKGROUND_CNT];   // background step functions (NULL = free slot)
+    int16_t  _bgbudget[MAX_BACKGROUND_CNT]; // max. duration of background time slice
+    uint8_t  _bgnext;                       // last executed background task (round robin)
+    #define STATE_BACKGROUND    (sizeof(_bgstep) + sizeof(_bgbudget) + sizeof(_bgnext))
+#else
+    #define STATE_BACKGROUND    0
+#endif
+
+// keep RAM report in Tasks.h in sync with above variables
+static_assert(sizeof(_activemask) + STATE_BUDGET + STATE_SHEDDING + STATE_EDF + STATE_HW +
+              sizeof(_nesting) + sizeof(_maxnesting) + sizeof(_peaknesting) + sizeof(_skippedticks) +
+              sizeof(_timeseq) + sizeof(_currenttask) + sizeof(_currentrelease) +
+              sizeof(SchedulingActive) + sizeof(_timebase) + sizeof(_nexttime) + sizeof(_lasttask) + sizeof(_taskcnt) +
+              STATE_BACKGROUND == TASKS_RAM_STATE,
+              "TASKS_RAM_STATE does not match scheduler variables");
 
 
 #if defined(__SAM3X8E__)
@@ -94,20 +250,22 @@ void Scheduler_update_nexttime(void)
     // stop interrupts, store old setting
     PAUSE_INTERRUPTS;
     
-    // find time of next task execution    
-    _nexttime = _timebase + INT16_MAX; // Max. possible delay of the next time
-    for (uint8_t i = 0; i < _lasttask; i++)
+    // find time of next task execution. Compare relative to _timebase, because overdue tasks (e.g. delayed by
+    // nested tasks under overload) would overflow the comparison with the max. delay and be lost for 32s
+    int16_t delay = INT16_MAX; // Max. possible delay of the next time
+    for (uint8_t w = 0; w < TASKS_MASK_WORDS(_lasttask); w++)
     {
-        if ((SchedulingTable[i].active == true) && (SchedulingTable[i].func != NULL))
+        // only check active tasks
+        TasksMask_t mask = _activemask[w];
+        for (uint8_t i = w * TASKS_MASK_BITS; mask != 0; i++, mask >>= 1)
         {
-            //Serial.print(i); Serial.print("    "); Serial.println(SchedulingTable[i].time);
-
-            if ((int16_t)(SchedulingTable[i].time - _nexttime) < 0)
+            if ((mask & 0x01) && ((int16_t)(SchedulingTime[i] - _timebase) < delay))
             {
-                _nexttime = SchedulingTable[i].time;
+                delay = SchedulingTime[i] - _timebase;
             }
         }
     }
+    _nexttime = _timebase + delay;
 
     //Serial.print("timebase: "); Serial.println(_timebase);
     //Serial.print("nexttime: "); Serial.println(_nexttime);
@@ -121,21 +279,312 @@ void Scheduler_update_nexttime(void)
 } // Scheduler_update_nexttime()
 
 
+// find slot of function in scheduler table. Must be called with interrupts paused. Returns 0xFF if not found.
+// NULL is never found, otherwise it would match a free slot
+uint8_t Scheduler_find_task(Task func)
+{
+    if (func == NULL)
+        return 0xFF;
+    for (uint8_t i = 0; i < _lasttask; i++)
+    {
+        if (SchedulingFunc[i] == func)
+            return i;
+    }
+    return 0xFF;
+
+} // Scheduler_find_task()
+
+
+#if (TASKS_USE_BACKGROUND)
+
+// get consistent copy of 1ms counter (16-bit access is not atomic on ATMega)
+int16_t Scheduler_get_timebase(void)
+{
+    PAUSE_INTERRUPTS;
+    int16_t time = _timebase;
+    RESUME_INTERRUPTS;
+
+    return time;
+
+} // Scheduler_get_timebase()
+
+
+// check if CPU is idle, i.e. no task is running or due within the next 1ms tick
+bool Scheduler_idle(void)
+{
+    PAUSE_INTERRUPTS;
+    bool idle = (_nesting == 0) && ((SchedulingActive == false) || ((int16_t)(_nexttime - _timebase) > 1));
+    RESUME_INTERRUPTS;
+
+    return idle;
+
+} // Scheduler_idle()
+
+#endif // TASKS_USE_BACKGROUND
+
+
+// pause or resume task on request of the application. A parked successor stays inactive until it is released,
+// see Scheduler_execute_task(). Must be called with interrupts paused
+void Scheduler_set_state(uint8_t i, bool state)
+{
+    #if (TASKS_USE_CHAINS)
+        if (state == true)
+            SchedulingFlags[i] &= ~TASK_FLAG_PAUSED;
+        else
+            SchedulingFlags[i] |= TASK_FLAG_PAUSED;
+        if (SchedulingFlags[i] & TASK_FLAG_PARKED)
+            state = false;
+    #endif
+
+    if (state == true)
+        _activemask[TASK_WORD(i)] |= TASK_BIT(i);
+    else
+        _activemask[TASK_WORD(i)] &= ~TASK_BIT(i);
+
+} // Scheduler_set_state()
+
+
+#if (TASKS_USE_CHAINS)
+
+// restart waiting of successor task for all its predecessors. Must be called with interrupts paused
+void Scheduler_reset_join(uint8_t j)
+{
+    SchedulingJoinLeft[j] = SchedulingJoin[j];
+    for (uint8_t k = 0; k < _lasttask; k++)
+    {
+        if (SchedulingSucc[k] == j)
+            SchedulingFlags[k] &= ~TASK_FLAG_JOINED;
+    }
+
+} // Scheduler_reset_join()
+
+
+// remove link from task to its successor. Must be called with interrupts paused
+void Scheduler_unlink_task(uint8_t i)
+{
+    uint8_t j = SchedulingSucc[i];
+
+    if (j == 0xFF)
+        return;
+
+    // successor waits for one predecessor less. Restart waiting for all remaining predecessors
+    SchedulingSucc[i] = 0xFF;
+    SchedulingFlags[i] &= ~TASK_FLAG_JOINED;
+    SchedulingJoin[j]--;
+    Scheduler_reset_join(j);
+
+} // Scheduler_unlink_task()
+
+#endif // TASKS_USE_CHAINS
+
+
+// remove task from scheduler slot and update _lasttask. Must be called with interrupts paused
+void Scheduler_remove_task(uint8_t i)
+{
+    // remove task from scheduler table
+    SchedulingFunc[i]           = NULL;
+    _activemask[TASK_WORD(i)]  &= ~TASK_BIT(i);
+    _runningmask[TASK_WORD(i)] &= ~TASK_BIT(i);
+    SchedulingPeriod[i]         = 0;
+    SchedulingTime[i]           = 0;
+    #if (TASKS_USE_EDF)
+        SchedulingDeadline[i]       = 0;
+    #endif
+    #if (TASKS_USE_SHEDDING)
+        SchedulingMinPeriod[i]      = 0;
+        SchedulingMaxPeriod[i]      = 0;
+        SchedulingCriticality[i]    = 0;
+    #endif
+    #if (TASKS_USE_BUDGET)
+        SchedulingBudget[i]         = 0;
+        SchedulingOverrun[i]        = 0;
+    #endif
+    #if (TASK_USE_FLAGS)
+        SchedulingFlags[i]          = 0;
+    #endif
+    #if (TASKS_USE_GROUPS)
+        SchedulingGroup[i]          = 0;
+    #endif
+
+    #if (TASKS_USE_CHAINS)
+        // remove links to predecessors and successor
+        Scheduler_unlink_task(i);
+        for (uint8_t k = 0; k < _lasttask; k++)
+        {
+            if (SchedulingSucc[k] == i)
+                SchedulingSucc[k] = 0xFF;
+        }
+        SchedulingJoin[i]           = 0;
+        SchedulingJoinLeft[i]       = 0;
+    #endif
+    
+    // update _lasttask
+    if (i == (_lasttask - 1))
+    {
+        _lasttask--;
+        while(_lasttask != 0)
+        {
+            if(SchedulingFunc[_lasttask - 1] != NULL)
+            {
+                break;
+            }
+            _lasttask--;
+        }
+    }
+
+} // Scheduler_remove_task()
+
+
+#if (TASKS_USE_BUDGET)
+
+// report tasks exceeding their execution budget. Is called every 1ms and must not be interrupted by the
+// scheduler interrupt (AVR: interrupts disabled, SAM: SysTick)
+void Scheduler_check_budget(void)
+{
+    int16_t now = SUPERVISION_TIME;
+
+    for (uint8_t w = 0; w < TASKS_MASK_WORDS(_lasttask); w++)
+    {
+        // only check running tasks
+        TasksMask_t mask = _runningmask[w];
+        for (uint8_t i = w * TASKS_MASK_BITS; mask != 0; i++, mask >>= 1)
+        {
+            if (((mask & 0x01) == 0) || (SchedulingBudget[i] == 0) || (SchedulingFlags[i] & TASK_FLAG_OVERRUN))
+                continue;
+
+            // budget exceeded -> report only once per execution
+            if ((int16_t)(now - SchedulingStart[i]) > SchedulingBudget[i])
+            {
+                SchedulingFlags[i] |= TASK_FLAG_OVERRUN;
+                if (SchedulingOverrun[i] != 0xFF)
+                    SchedulingOverrun[i]++;
+
+                // deactivate task. Is not called again after it returns, also not if released as successor
+                if (SchedulingFlags[i] & TASKS_OVERRUN_DISABLE)
+                    Scheduler_set_state(i, false);
+
+                // notify application
+                if (_overrunhook != NULL)
+                    _overrunhook(SchedulingFunc[i]);
+
+                // reset controller
+                if (SchedulingFlags[i] & TASKS_OVERRUN_RESET)
+                {
+                    #if defined(__AVR__)
+                        wdt_enable(WDTO_15MS);
+                        while (1);
+                    #elif defined(__SAM3X8E__)
+                        NVIC_SystemReset();
+                    #endif
+                }
+            } // if budget exceeded
+        } // loop over running slots
+    } // loop over bitmask words
+
+} // Scheduler_check_budget()
+
+#endif // TASKS_USE_BUDGET
+
+
+#if (TASKS_USE_SHEDDING)
+
+// measure CPU load as share of time with a running task and adapt the periods of non-critical tasks. The busy time
+// is accumulated by the scheduler interrupt when leaving the outermost nesting level.
+// Is called every 1ms and must not be interrupted by the scheduler interrupt (AVR: interrupts disabled, SAM: SysTick)
+void Scheduler_measure_load(void)
+{
+    uint32_t now, load;
+
+    if (SchedulingActive == false)
+        return;
+
+    // add busy time of task interrupted by this tick
+    if (_nesting != 0)
+    {
+        now = Tasks_Now();
+        _busytime += now - _busystart;
+        _busystart = now;
+    }
+    if (++_loadticks < LOAD_WINDOW)
+        return;
+
+    // end of window -> store load in % (busy time is in 1/65536 ticks)
+    load = ((_busytime * 100U) / LOAD_WINDOW) >> 16;
+    _load = (load > 100) ? 100 : (uint8_t) load;
+    _loadticks = 0;
+    _busytime = 0;
+
+    for (uint8_t i = 0; i < _lasttask; i++)
+    {
+        // skip tasks without period range
+        if (SchedulingMaxPeriod[i] == 0)
+            continue;
+
+        // overload -> double period of non-critical tasks up to max. period
+        if ((_load >= _shedhigh) && (SchedulingCriticality[i] < _shedcrit))
+        {
+            if (SchedulingPeriod[i] > SchedulingMaxPeriod[i] / 2)
+                SchedulingPeriod[i] = SchedulingMaxPeriod[i];
+            else
+                SchedulingPeriod[i] *= 2;
+        }
+
+        // low load -> halve period of all stretched tasks down to min. period
+        else if (_load <= _shedlow)
+        {
+            if (SchedulingPeriod[i] / 2 < SchedulingMinPeriod[i])
+                SchedulingPeriod[i] = SchedulingMinPeriod[i];
+            else
+                SchedulingPeriod[i] /= 2;
+        }
+    } // loop over scheduler slots
+
+} // Scheduler_measure_load()
+
+#endif // TASKS_USE_SHEDDING
+
+
 /// @endcond
 /************************************/
 /******* end skip in doxygen ********/
 /************************************/
 
 
-void Tasks_Init(void)
+bool Tasks_Init(void)
 {
-    /*static bool flagDone = false;
+    static TasksMask_t buffer[TASKS_BUFFER_WORDS(MAX_TASK_CNT)];    // default task table
     
+    return Tasks_Init(buffer, MAX_TASK_CNT);
+
+} // Tasks_Init()
+
+
+
+bool Tasks_Init(TasksMask_t *buffer, uint8_t cnt, uint8_t features)
+{
+    // buffer was sized for different optional features, i.e. sketch and library disagree on table layout -> error
+    if ((buffer == NULL) || (cnt == 0) || (features != TASKS_FEATURES))
+        return false;
+
     // clear tasks schedule only for first call to avoid issues when calling multiple times
-    if (flagDone == false) {
-        flagDone = true;
-        Tasks_Clear();    
-    }*/
+    if ((buffer == _activemask) && (cnt == _taskcnt))
+        return true;
+
+    // stop interrupts, store old setting
+    PAUSE_INTERRUPTS;
+
+    // use buffer as task table. Location of arrays is derived from number of slots, see TABLE()
+    _activemask = buffer;
+    _taskcnt    = cnt;
+
+    // reset scheduler and new task table
+    Tasks_Clear();
+
+    // resume stored interrupt setting
+    RESUME_INTERRUPTS;
+
+    // return success
+    return true;
 
 } // Tasks_Init()
 
@@ -153,15 +602,46 @@ void Tasks_Clear(void)
     _timebase = 0;
     _nexttime = 0;
     _lasttask = 0;
-    for(i = 0; i < MAX_TASK_CNT; i++)
+    _currenttask = 0xFF;
+    #if (TASKS_USE_BUDGET)
+        _budgetused = false;
+    #endif
+    for(i = 0; i < _taskcnt; i++)
     {
         //Reset scheduling table
-        SchedulingTable[i].func = NULL;
-        SchedulingTable[i].active = false;
-        SchedulingTable[i].running = false;
-        SchedulingTable[i].period = 0;
-        SchedulingTable[i].time = 0;
+        SchedulingFunc[i] = NULL;
+        SchedulingPeriod[i] = 0;
+        SchedulingTime[i] = 0;
+        #if (TASKS_USE_EDF)
+            SchedulingDeadline[i] = 0;
+        #endif
+        #if (TASKS_USE_SHEDDING)
+            SchedulingMinPeriod[i] = 0;
+            SchedulingMaxPeriod[i] = 0;
+            SchedulingCriticality[i] = 0;
+        #endif
+        #if (TASKS_USE_BUDGET)
+            SchedulingBudget[i] = 0;
+            SchedulingStart[i] = 0;
+            SchedulingOverrun[i] = 0;
+        #endif
+        #if (TASK_USE_FLAGS)
+            SchedulingFlags[i] = 0;
+        #endif
+        #if (TASKS_USE_GROUPS)
+            SchedulingGroup[i] = 0;
+        #endif
+        #if (TASKS_USE_CHAINS)
+            SchedulingSucc[i] = 0xFF;
+            SchedulingJoin[i] = 0;
+            SchedulingJoinLeft[i] = 0;
+        #endif
     } // loop over scheduler slots
+    for(i = 0; i < TASKS_MASK_WORDS(_taskcnt); i++)
+    {
+        _activemask[i] = 0;
+        _runningmask[i] = 0;
+    } // loop over bitmask words
     
     // resume stored interrupt setting
     RESUME_INTERRUPTS;
@@ -172,8 +652,8 @@ void Tasks_Clear(void)
 
 bool Tasks_Add(Task func, int16_t period, int16_t delay)
 {
-    // Check range of period and delay
-    if ((period < 0) || (delay < 0))
+    // Check function and range of period and delay. A NULL function would occupy a slot which is considered free
+    if ((func == NULL) || (period < 0) || (delay < 0))
         return false;
     
     // workaround for 1.024ms timer period of Arduino ATMega
@@ -181,52 +661,93 @@ bool Tasks_Add(Task func, int16_t period, int16_t delay)
         delay = (uint16_t)(((((int32_t)delay) * 250) + 128) >> 8); // delay = delay / 1.024 <-- with up/down rounding
         period = (uint16_t)(((((int32_t)period) * 250) + 128) >> 8); // period = period / 1.024 <-- with up/down rounding
     #endif
+
+    // no task table, i.e. Tasks_Init() not called -> error. Is not called here, otherwise the library buffer 
+    // would always be linked
+    if (_taskcnt == 0)
+        return false;
     
+    // stop interrupts for the complete search. Otherwise a task adding the same function in between
+    // the duplicate check and the insertion could occupy two slots. Store old setting
+    PAUSE_INTERRUPTS;
+
     // Check if task already exists and update it in this case
     for(uint8_t i = 0; i < _lasttask; i++)
     {
-        // stop interrupts when accessing any element within the scheduler (also neccessary for if checks!), store old setting
-        PAUSE_INTERRUPTS;
-
         // same function found
-        if (SchedulingTable[i].func == func)
+        if (SchedulingFunc[i] == func)
         {
-            SchedulingTable[i].active    = true;
-            SchedulingTable[i].running = false;
-            SchedulingTable[i].period    = period;
-            SchedulingTable[i].time        = _timebase + delay;
-            
+            _activemask[TASK_WORD(i)]  |= TASK_BIT(i);
+            _runningmask[TASK_WORD(i)] &= ~TASK_BIT(i);
+            SchedulingPeriod[i]         = period;
+            SchedulingTime[i]           = _timebase + delay;
+            #if (TASKS_USE_EDF)
+                SchedulingDeadline[i]       = 0;
+            #endif
+            #if (TASKS_USE_SHEDDING)
+                SchedulingMinPeriod[i]      = 0;
+                SchedulingMaxPeriod[i]      = 0;
+                SchedulingCriticality[i]    = 0;
+            #endif
+            #if (TASKS_USE_BUDGET)
+                SchedulingBudget[i]         = 0;
+                SchedulingOverrun[i]        = 0;
+            #endif
+            #if (TASK_USE_FLAGS)
+                SchedulingFlags[i]         &= TASK_FLAG_JOINED;     // keep state of task chain
+            #endif
+            #if (TASKS_USE_GROUPS)
+                SchedulingGroup[i]          = 0;
+            #endif
+
             // resume stored interrupt setting
             RESUME_INTERRUPTS;
 
             // find time for next task execution
             Scheduler_update_nexttime();
 
-            // return success        
+            // return success
             return true;
         }
 
-        // resume stored interrupt setting
-        RESUME_INTERRUPTS;
-
     } // loop over scheduler slots
-    
+
     // find free scheduler slot
-    for (uint8_t i = 0; i < MAX_TASK_CNT; i++)
+    for (uint8_t i = 0; i < _taskcnt; i++)
     {
-        // stop interrupts when accessing any element within the scheduler (also neccessary for if checks!), store old setting
-        PAUSE_INTERRUPTS;
-
-        // free slot found    
-        if (SchedulingTable[i].func == NULL)
+        // free slot found
+        if (SchedulingFunc[i] == NULL)
         {
             // add task to scheduler table
-            SchedulingTable[i].func        = func;
-            SchedulingTable[i].active    = true;
-            SchedulingTable[i].running = false;
-            SchedulingTable[i].period    = period;
-            SchedulingTable[i].time        = _timebase + delay;
-            
+            SchedulingFunc[i]           = func;
+            _activemask[TASK_WORD(i)]  |= TASK_BIT(i);
+            _runningmask[TASK_WORD(i)] &= ~TASK_BIT(i);
+            SchedulingPeriod[i]         = period;
+            SchedulingTime[i]           = _timebase + delay;
+            #if (TASKS_USE_EDF)
+                SchedulingDeadline[i]       = 0;
+            #endif
+            #if (TASKS_USE_SHEDDING)
+                SchedulingMinPeriod[i]      = 0;
+                SchedulingMaxPeriod[i]      = 0;
+                SchedulingCriticality[i]    = 0;
+            #endif
+            #if (TASKS_USE_BUDGET)
+                SchedulingBudget[i]         = 0;
+                SchedulingOverrun[i]        = 0;
+            #endif
+            #if (TASK_USE_FLAGS)
+                SchedulingFlags[i]          = 0;
+            #endif
+            #if (TASKS_USE_GROUPS)
+                SchedulingGroup[i]          = 0;
+            #endif
+            #if (TASKS_USE_CHAINS)
+                SchedulingSucc[i]           = 0xFF;
+                SchedulingJoin[i]           = 0;
+                SchedulingJoinLeft[i]       = 0;
+            #endif
+
             // update _lasttask
             if (i >= _lasttask)
                 _lasttask = i + 1;
@@ -237,16 +758,16 @@ bool Tasks_Add(Task func, int16_t period, int16_t delay)
             // find time for next task execution
             Scheduler_update_nexttime();
 
-            // return success            
+            // return success
             return true;
 
         } // if free slot found
 
-        // resume stored interrupt setting
-        RESUME_INTERRUPTS;
-
     } // loop over scheduler slots
 
+    // resume stored interrupt setting
+    RESUME_INTERRUPTS;
+
     // did not change anything, thus no scheduler_update_nexttime neccessary
     // no free slot found -> error
     return false;
@@ -264,28 +785,10 @@ bool Tasks_Remove(Task func)
         PAUSE_INTERRUPTS;
     
         // function pointer found in list    
-        if (SchedulingTable[i].func == func)
+        if (SchedulingFunc[i] == func)
         {
             // remove task from scheduler table
-            SchedulingTable[i].func        = NULL;
-            SchedulingTable[i].active    = false;
-            SchedulingTable[i].running = false;
-            SchedulingTable[i].period    = 0;
-            SchedulingTable[i].time        = 0;
-            
-            // update _lasttask
-            if (i == (_lasttask - 1))
-            {
-                _lasttask--;
-                while(_lasttask != 0)
-                {
-                    if(SchedulingTable[_lasttask - 1].func != NULL)
-                    {
-                        break;
-                    }
-                    _lasttask--;
-                }
-            }
+            Scheduler_remove_task(i);
 
             // resume stored interrupt setting
             RESUME_INTERRUPTS;
@@ -329,14 +832,14 @@ bool Tasks_Delay(Task func, int16_t delay)
         PAUSE_INTERRUPTS;
         
         // function pointer found in list
-        if (SchedulingTable[i].func == func)
+        if (SchedulingFunc[i] == func)
         {
             // if task is currently running, delay next call
-            if (SchedulingTable[i].running == true)
-                SchedulingTable[i].time = SchedulingTable[i].time - SchedulingTable[i].period;
+            if (_runningmask[TASK_WORD(i)] & TASK_BIT(i))
+                SchedulingTime[i] = SchedulingTime[i] - SchedulingPeriod[i];
         
             // set time to next execution
-            SchedulingTable[i].time = _timebase + delay;
+            SchedulingTime[i] = _timebase + delay;
 
             // resume stored interrupt setting
             RESUME_INTERRUPTS;
@@ -371,11 +874,11 @@ bool Tasks_SetState(Task func, bool state)
         PAUSE_INTERRUPTS;
             
         // function pointer found in list        
-        if(SchedulingTable[i].func == func)
+        if(SchedulingFunc[i] == func)
         {
             // set new function state            
-            SchedulingTable[i].active = state;
-            SchedulingTable[i].time = _timebase + SchedulingTable[i].period;
+            Scheduler_set_state(i, state);
+            SchedulingTime[i] = _timebase + SchedulingPeriod[i];
 
             // resume stored interrupt setting
             RESUME_INTERRUPTS;
@@ -401,63 +904,850 @@ bool Tasks_SetState(Task func, bool state)
 
 
 
-void Tasks_Start(void)
+#if (TASKS_USE_BACKGROUND)
+
+bool Tasks_Add_Background(TaskStep step, int16_t budget)
 {
-    #if (TASKS_MEASURE_PIN)
-        pinMode(9, OUTPUT);
-    #endif
+    uint8_t i, slot = 0xFF;
 
-    // enable scheduler
-    SchedulingActive = true;
-    //_timebase = 0;        // unwanted delay after resume, see time-print() output! -> likely delete
-    
-    _nexttime = _timebase;  // Scheduler should perform a full check of all tasks after the next start
-    
-    // enable timer interrupt
+    // Check range of budget
+    if ((step == NULL) || (budget < 0))
+        return false;
+
+    // Workaround for 1.024ms timer period of Arduino ATMega
     #if defined(__AVR__)
-        TIMSK0 |= (1<<OCIE0A);                      // Enable OC0A Interrupt
-    #elif defined(__SAM3X8E__)
-        startTasksTimer(TC1, 0, TC3_IRQn, 1000);    // TC1 channel 0, the IRQ for that channel and the desired frequency
+        budget = (uint16_t)(((((int32_t)budget) * 250) + 128) >> 8); // budget = budget / 1.024 <-- with up/down rounding
     #endif
 
-    // find time for next task execution
-    Scheduler_update_nexttime();
-    
-} // Tasks_Start()
+    // stop interrupts, background tasks may also be added by scheduled tasks. Store old setting
+    PAUSE_INTERRUPTS;
 
+    // find same function or else free slot
+    for (i = 0; i < MAX_BACKGROUND_CNT; i++)
+    {
+        if (_bgstep[i] == step)
+        {
+            slot = i;
+            break;
+        }
+        if ((_bgstep[i] == NULL) && (slot == 0xFF))
+            slot = i;
+    } // loop over background slots
 
+    // no free slot found -> error
+    if (slot == 0xFF)
+    {
+        RESUME_INTERRUPTS;
+        return false;
+    }
 
-void Tasks_Pause(void)
-{
-    // pause scheduler
-    SchedulingActive = false;
-    //_timebase = 0; // unwanted delay after resume, see time-print() output! -> likely delete 
-    
-    // disable timer interrupt
-    #if defined(__AVR__)
-        TIMSK0 &= ~(1<<OCIE0A); //Disable OC0A Interrupt
-    #elif defined(__SAM3X8E__)
-        NVIC_DisableIRQ(TC3_IRQn);
-    #endif
+    // add background task
+    _bgstep[slot]   = step;
+    _bgbudget[slot] = budget;
 
-} // Tasks_Pause()
+    // resume stored interrupt setting
+    RESUME_INTERRUPTS;
 
+    // return success
+    return true;
 
+} // Tasks_Add_Background()
 
-/**************************************/
-/******* start skip in doxygen ********/
-/**************************************/
-/// @cond INTERNAL
 
-#if defined(__AVR__)
-    ISR(TIMER0_COMPA_vect)  // Timer0 interrupt is called each 1.024ms before the OVL interrupt used for millis()
-#elif defined(__SAM3X8E__)
-    void TC3_Handler(void)
+
+bool Tasks_Remove_Background(TaskStep step)
+{
+    // stop interrupts, store old setting
+    PAUSE_INTERRUPTS;
+
+    for (uint8_t i = 0; i < MAX_BACKGROUND_CNT; i++)
+    {
+        if (_bgstep[i] == step)
+        {
+            _bgstep[i] = NULL;
+            RESUME_INTERRUPTS;
+            return true;
+        }
+    } // loop over background slots
+
+    // resume stored interrupt setting
+    RESUME_INTERRUPTS;
+
+    // function not in list -> error
+    return false;
+
+} // Tasks_Remove_Background()
+
+
+
+bool Tasks_Idle(void)
+{
+    TaskStep step = NULL;
+    int16_t  budget = 0;
+
+    // find next background task (round robin)
+    {
+        PAUSE_INTERRUPTS;
+        for (uint8_t i = 0; (i < MAX_BACKGROUND_CNT) && (step == NULL); i++)
+        {
+            _bgnext = (_bgnext + 1) % MAX_BACKGROUND_CNT;
+            step    = _bgstep[_bgnext];
+            budget  = _bgbudget[_bgnext];
+        }
+        RESUME_INTERRUPTS;
+    }
+
+    // no background task pending
+    if (step == NULL)
+        return false;
+
+    // execute steps only in idle time until budget of time slice is used up
+    int16_t start = Scheduler_get_timebase();
+    while (Scheduler_idle())
+    {
+        // step finished -> remove background task
+        if (step() == false)
+        {
+            Tasks_Remove_Background(step);
+            break;
+        }
+
+        // budget of time slice used up
+        if ((int16_t)(Scheduler_get_timebase() - start) >= budget)
+            break;
+    }
+
+    return true;
+
+} // Tasks_Idle()
+
+#endif // TASKS_USE_BACKGROUND
+
+
+
+#if (TASKS_USE_GROUPS)
+
+bool Tasks_SetGroup(Task func, uint8_t group)
+{
+    // stop interrupts when accessing any element within the scheduler, store old setting
+    PAUSE_INTERRUPTS;
+
+    // function not in scheduler -> error
+    uint8_t i = Scheduler_find_task(func);
+    if (i == 0xFF)
+    {
+        RESUME_INTERRUPTS;
+        return false;
+    }
+
+    // set group membership
+    SchedulingGroup[i] = group;
+
+    // resume stored interrupt setting
+    RESUME_INTERRUPTS;
+
+    // return success
+    return true;
+
+} // Tasks_SetGroup()
+
+
+
+uint8_t Tasks_SetState_Group(uint8_t group, bool state)
+{
+    uint8_t cnt = 0;
+
+    // stop interrupts for all tasks, i.e. the scheduler never sees a partly switched group. Store old setting
+    PAUSE_INTERRUPTS;
+
+    // set new state of all group members
+    for (uint8_t i = 0; i < _lasttask; i++)
+    {
+        if ((SchedulingFunc[i] != NULL) && (SchedulingGroup[i] & group))
+        {
+            Scheduler_set_state(i, state);
+            SchedulingTime[i] = _timebase + SchedulingPeriod[i];
+            cnt++;
+        }
+    } // loop over scheduler slots
+
+    // find time for next task execution (once for all tasks)
+    if (cnt != 0)
+        Scheduler_update_nexttime();
+
+    // resume stored interrupt setting
+    RESUME_INTERRUPTS;
+
+    return cnt;
+
+} // Tasks_SetState_Group()
+
+
+
+uint8_t Tasks_Delay_Group(uint8_t group, int16_t delay)
+{
+    uint8_t cnt = 0;
+
+    // Check range of delay
+    if (delay < 0)
+        return 0;
+    
+    // Workaround for 1.024ms timer period of Arduino MEGA
+    #if defined(__AVR__)
+        delay = (uint16_t)(((((int32_t)delay) * 250) + 128) >> 8); // delay = delay / 1.024 <-- with up/down rounding
+    #endif
+
+    // stop interrupts for all tasks, i.e. the scheduler never sees a partly delayed group. Store old setting
+    PAUSE_INTERRUPTS;
+
+    // set time to next execution of all group members
+    for (uint8_t i = 0; i < _lasttask; i++)
+    {
+        if ((SchedulingFunc[i] != NULL) && (SchedulingGroup[i] & group))
+        {
+            SchedulingTime[i] = _timebase + delay;
+            cnt++;
+        }
+    } // loop over scheduler slots
+
+    // find time for next task execution (once for all tasks)
+    if (cnt != 0)
+        Scheduler_update_nexttime();
+
+    // resume stored interrupt setting
+    RESUME_INTERRUPTS;
+
+    return cnt;
+
+} // Tasks_Delay_Group()
+
+
+
+uint8_t Tasks_Remove_Group(uint8_t group)
+{
+    uint8_t cnt = 0;
+
+    // stop interrupts for all tasks, store old setting
+    PAUSE_INTERRUPTS;
+
+    // remove all group members. Loop downwards, because _lasttask may shrink
+    for (uint8_t i = _lasttask; i > 0; i--)
+    {
+        if ((SchedulingFunc[i - 1] != NULL) && (SchedulingGroup[i - 1] & group))
+        {
+            Scheduler_remove_task(i - 1);
+            cnt++;
+        }
+    } // loop over scheduler slots
+
+    // find time for next task execution (once for all tasks)
+    if (cnt != 0)
+        Scheduler_update_nexttime();
+
+    // resume stored interrupt setting
+    RESUME_INTERRUPTS;
+
+    return cnt;
+
+} // Tasks_Remove_Group()
+
+#endif // TASKS_USE_GROUPS
+
+
+
+#if (TASKS_USE_CHAINS)
+
+bool Tasks_Chain(Task pred, Task succ)
+{
+    // stop interrupts when accessing any element within the scheduler, store old setting
+    PAUSE_INTERRUPTS;
+
+    // predecessor not in scheduler -> error
+    uint8_t i = Scheduler_find_task(pred);
+    if (i == 0xFF)
+    {
+        RESUME_INTERRUPTS;
+        return false;
+    }
+
+    // only remove existing link
+    if (succ == NULL)
+    {
+        Scheduler_unlink_task(i);
+        RESUME_INTERRUPTS;
+        return true;
+    }
+
+    // successor not in scheduler -> error. Existing link is kept
+    uint8_t j = Scheduler_find_task(succ);
+    if (j == 0xFF)
+    {
+        RESUME_INTERRUPTS;
+        return false;
+    }
+
+    // cycles would release tasks endlessly within one tick -> error. Existing link is kept
+    for (uint8_t k = j, n = 0; (k != 0xFF) && (n < _lasttask); k = SchedulingSucc[k], n++)
+    {
+        if (k == i)
+        {
+            RESUME_INTERRUPTS;
+            return false;
+        }
+    }
+
+    // replace existing link. Successor additionally waits for this predecessor, restart waiting for all predecessors
+    Scheduler_unlink_task(i);
+    SchedulingSucc[i] = j;
+    SchedulingJoin[j]++;
+    Scheduler_reset_join(j);
+
+    // successor without period is parked, i.e. only executed when released
+    if (SchedulingPeriod[j] == 0)
+    {
+        SchedulingFlags[j] |= TASK_FLAG_PARKED;
+        _activemask[TASK_WORD(j)] &= ~TASK_BIT(j);
+    }
+
+    // resume stored interrupt setting
+    RESUME_INTERRUPTS;
+
+    // find time for next task execution
+    Scheduler_update_nexttime();
+
+    // return success
+    return true;
+
+} // Tasks_Chain()
+
+#endif // TASKS_USE_CHAINS
+
+
+
+#if (TASKS_USE_EDF)
+
+bool Tasks_SetDeadline(Task func, int16_t deadline)
+{
+    // Check range of deadline
+    if (deadline < 0)
+        return false;
+
+    // Workaround for 1.024ms timer period of Arduino ATMega
+    #if defined(__AVR__)
+        deadline = (uint16_t)(((((int32_t)deadline) * 250) + 128) >> 8); // deadline = deadline / 1.024 <-- with up/down rounding
+    #endif
+
+    // stop interrupts when accessing any element within the scheduler, store old setting
+    PAUSE_INTERRUPTS;
+
+    // function not in scheduler -> error
+    uint8_t i = Scheduler_find_task(func);
+    if (i == 0xFF)
+    {
+        RESUME_INTERRUPTS;
+        return false;
+    }
+
+    // set deadline, applies from next release on
+    SchedulingDeadline[i] = deadline;
+
+    // resume stored interrupt setting
+    RESUME_INTERRUPTS;
+
+    // return success
+    return true;
+
+} // Tasks_SetDeadline()
+
+
+
+void Tasks_SetMode(uint8_t mode)
+{
+    // 8-bit access is atomic. Takes effect with next scheduler tick
+    _schedulingmode = mode;
+
+} // Tasks_SetMode()
+
+#endif // TASKS_USE_EDF
+
+
+
+#if (TASKS_USE_SHEDDING)
+
+bool Tasks_SetPeriodRange(Task func, int16_t minperiod, int16_t maxperiod, uint8_t criticality)
+{
+    // Check range of periods
+    if ((minperiod <= 0) || (maxperiod < minperiod))
+        return false;
+
+    // Workaround for 1.024ms timer period of Arduino ATMega
+    #if defined(__AVR__)
+        minperiod = (uint16_t)(((((int32_t)minperiod) * 250) + 128) >> 8); // minperiod = minperiod / 1.024 <-- with up/down rounding
+        maxperiod = (uint16_t)(((((int32_t)maxperiod) * 250) + 128) >> 8); // maxperiod = maxperiod / 1.024 <-- with up/down rounding
+    #endif
+
+    // stop interrupts when accessing any element within the scheduler, store old setting
+    PAUSE_INTERRUPTS;
+
+    // function not in scheduler or one-shot task -> error
+    uint8_t i = Scheduler_find_task(func);
+    if ((i == 0xFF) || (SchedulingPeriod[i] == 0))
+    {
+        RESUME_INTERRUPTS;
+        return false;
+    }
+
+    // start with min. period, applies from next release on
+    SchedulingPeriod[i]      = minperiod;
+    SchedulingMinPeriod[i]   = minperiod;
+    SchedulingMaxPeriod[i]   = maxperiod;
+    SchedulingCriticality[i] = criticality;
+
+    // resume stored interrupt setting
+    RESUME_INTERRUPTS;
+
+    // return success
+    return true;
+
+} // Tasks_SetPeriodRange()
+
+
+
+void Tasks_SetShedding(uint8_t high, uint8_t low, uint8_t criticality)
+{
+    // stop interrupts to change all thresholds at once, store old setting
+    PAUSE_INTERRUPTS;
+
+    _shedhigh = high;
+    _shedlow  = low;
+    _shedcrit = criticality;
+
+    // restart load measurement
+    _loadticks = 0;
+    _busytime  = 0;
+    _busystart = Tasks_Now();
+
+    // resume stored interrupt setting
+    RESUME_INTERRUPTS;
+
+} // Tasks_SetShedding()
+
+
+
+uint8_t Tasks_GetLoad(void)
+{
+    return _load;
+
+} // Tasks_GetLoad()
+
+#endif // TASKS_USE_SHEDDING
+
+
+
+#if (TASKS_USE_BUDGET)
+
+bool Tasks_SetBudget(Task func, int16_t budget, uint8_t action)
+{
+    // Check range of budget
+    if (budget < 0)
+        return false;
+
+    // Workaround for 1.024ms timer period of Arduino ATMega
+    #if defined(__AVR__)
+        budget = (uint16_t)(((((int32_t)budget) * 250) + 128) >> 8); // budget = budget / 1.024 <-- with up/down rounding
+    #endif
+
+    // stop interrupts when accessing any element within the scheduler, store old setting
+    PAUSE_INTERRUPTS;
+
+    // function not in scheduler -> error
+    uint8_t i = Scheduler_find_task(func);
+    if (i == 0xFF)
+    {
+        RESUME_INTERRUPTS;
+        return false;
+    }
+
+    // set budget and action, reset overrun counter. Enable supervision of running tasks
+    if (budget != 0)
+        _budgetused = true;
+    SchedulingBudget[i]  = budget;
+    SchedulingOverrun[i] = 0;
+    SchedulingFlags[i]   = (SchedulingFlags[i] & ~(TASKS_OVERRUN_DISABLE | TASKS_OVERRUN_RESET)) | 
+                           (action & (TASKS_OVERRUN_DISABLE | TASKS_OVERRUN_RESET));
+
+    // resume stored interrupt setting
+    RESUME_INTERRUPTS;
+
+    // return success
+    return true;
+
+} // Tasks_SetBudget()
+
+
+
+uint8_t Tasks_GetOverruns(Task func)
+{
+    uint8_t cnt = 0;
+
+    // stop interrupts when accessing any element within the scheduler, store old setting
+    PAUSE_INTERRUPTS;
+
+    uint8_t i = Scheduler_find_task(func);
+    if (i != 0xFF)
+        cnt = SchedulingOverrun[i];
+
+    // resume stored interrupt setting
+    RESUME_INTERRUPTS;
+
+    return cnt;
+
+} // Tasks_GetOverruns()
+
+
+
+void Tasks_SetOverrunHook(TaskOverrunHook hook)
+{
+    // pointer access is not atomic on ATMega
+    PAUSE_INTERRUPTS;
+    _overrunhook = hook;
+    RESUME_INTERRUPTS;
+
+} // Tasks_SetOverrunHook()
+
+#endif // TASKS_USE_BUDGET
+
+
+
+void Tasks_SysTick(void)
+{
+    // SysTick has a higher priority than the scheduler interrupt, i.e. it is also executed while a task hangs
+    #if defined(__SAM3X8E__) && (TASKS_USE_BUDGET)
+        if (_budgetused)
+            Scheduler_check_budget();
+    #endif
+    #if defined(__SAM3X8E__) && (TASKS_USE_SHEDDING)
+        if (_shedhigh != 0)
+            Scheduler_measure_load();
+    #endif
+
+} // Tasks_SysTick()
+
+
+
+void Tasks_SetMaxNesting(uint8_t depth)
+{
+    _maxnesting = depth;
+
+} // Tasks_SetMaxNesting()
+
+
+
+uint8_t Tasks_GetPeakNesting(void)
+{
+    return _peaknesting;
+
+} // Tasks_GetPeakNesting()
+
+
+
+uint16_t Tasks_GetSkippedTicks(void)
+{
+    uint16_t cnt;
+
+    // 16-bit access is not atomic on ATMega
+    PAUSE_INTERRUPTS;
+    cnt = _skippedticks;
+    RESUME_INTERRUPTS;
+
+    return cnt;
+
+} // Tasks_GetSkippedTicks()
+
+
+
+void Tasks_PaintStack(void)
+{
+    uint8_t marker;     // located at current stack pointer
+    uint8_t *p   = FREE_RAM_START;
+    uint8_t *end = (uint8_t*) ((size_t) &marker - STACK_MARGIN);
+
+    // fill free RAM between end of heap and current stack pointer. Interrupts push their frames below the
+    // stack pointer, i.e. into the painted area. Therefore only pause interrupts while painting a small chunk,
+    // then all interrupts which occurred in between have returned. This keeps interrupt latency short
+    while (p < end)
+    {
+        PAUSE_INTERRUPTS;
+        for (uint8_t n = 0; (n < STACK_CHUNK) && (p < end); n++, p++)
+            *p = STACK_PATTERN;
+        RESUME_INTERRUPTS;
+    }
+
+} // Tasks_PaintStack()
+
+
+
+size_t Tasks_GetStackFree(void)
+{
+    uint8_t  marker;    // located at current stack pointer
+    size_t   cnt = 0;   // free RAM exceeds 64kB on SAM
+
+    // count untouched bytes starting at end of heap
+    for (uint8_t *p = FREE_RAM_START; (p < &marker) && (*p == STACK_PATTERN); p++)
+        cnt++;
+
+    return cnt;
+
+} // Tasks_GetStackFree()
+
+
+
+uint32_t Tasks_Now(void)
+{
+    uint8_t  seq;
+    uint16_t tick;
+    #if defined(__AVR__)
+        uint16_t fraction;
+        bool     pending;
+    #elif defined(__SAM3X8E__)
+        uint32_t us;
+    #endif
+
+    // repeat reading in case the scheduler interrupt updated the 1ms counter in the meantime
+    do
+    {
+        seq = _timeseq;
+        tick = *((volatile int16_t*) &_timebase);
+        #if defined(__AVR__)
+            fraction = (uint8_t) (TCNT0 - OCR0A);                       // compare match is tick start
+            pending = (TIFR0 & (1 << OCF0A)) && (fraction < 255);       // tick not yet counted (interrupts disabled)
+            fraction <<= 8;
+        #elif defined(__SAM3X8E__)
+            us = SchedulingActive ? (micros() - _tickmicros) : 0;      // time since start of last counted tick
+        #endif
+    } while (seq != _timeseq);
+
+    #if defined(__AVR__)
+        // add tick which has not been counted yet
+        if (pending && SchedulingActive)
+            tick++;
+
+        return ((uint32_t) tick << 16) | fraction;
+
+    #elif defined(__SAM3X8E__)
+        // the scheduler interrupt does not nest, i.e. the 1ms counter stands still while a task runs for more than
+        // 1ms. micros() is based on SysTick and keeps running, thus it also provides the ticks not yet counted
+        return ((uint32_t) tick << 16) + ((us / TASKS_TICK_US) << 16) + (((us % TASKS_TICK_US) << 16) / TASKS_TICK_US);
+    #endif
+
+} // Tasks_Now()
+
+
+
+uint32_t Tasks_Release(void)
+{
+    uint16_t tick;
+
+    // 16-bit access is not atomic on ATMega
+    PAUSE_INTERRUPTS;
+    tick = (_currenttask == 0xFF) ? 0 : _currentrelease;
+    RESUME_INTERRUPTS;
+
+    return (uint32_t) tick << 16;
+
+} // Tasks_Release()
+
+
+
+void Tasks_Start(void)
+{
+    #if (TASKS_MEASURE_PIN)
+        pinMode(9, OUTPUT);
+    #endif
+
+    // enable scheduler
+    SchedulingActive = true;
+    //_timebase = 0;        // unwanted delay after resume, see time-print() output! -> likely delete
+    
+    _nexttime = _timebase;  // Scheduler should perform a full check of all tasks after the next start
+    
+    // enable timer interrupt
+    #if defined(__AVR__)
+        TIMSK0 |= (1<<OCIE0A);                      // Enable OC0A Interrupt
+    #elif defined(__SAM3X8E__)
+        _tickmicros = micros();                     // timer restarts, see Tasks_Now()
+        startTasksTimer(TC1, 0, TC3_IRQn, 1000);    // TC1 channel 0, the IRQ for that channel and the desired frequency
+    #endif
+
+    // find time for next task execution
+    Scheduler_update_nexttime();
+    
+} // Tasks_Start()
+
+
+
+void Tasks_Pause(void)
+{
+    // pause scheduler
+    SchedulingActive = false;
+    //_timebase = 0; // unwanted delay after resume, see time-print() output! -> likely delete 
+    
+    // disable timer interrupt
+    #if defined(__AVR__)
+        TIMSK0 &= ~(1<<OCIE0A); //Disable OC0A Interrupt
+    #elif defined(__SAM3X8E__)
+        NVIC_DisableIRQ(TC3_IRQn);
+    #endif
+
+} // Tasks_Pause()
+
+
+
+/**************************************/
+/******* start skip in doxygen ********/
+/**************************************/
+/// @cond INTERNAL
+
+#if (TASKS_USE_EDF)
+
+// relative deadline of task. Must be called with interrupts disabled
+int16_t Scheduler_get_deadline(uint8_t i)
+{
+    return (SchedulingDeadline[i] != 0) ? SchedulingDeadline[i] : SchedulingPeriod[i];
+
+} // Scheduler_get_deadline()
+
+
+// find due task with earliest absolute deadline. While a task is executing, only a task with an earlier
+// deadline is returned (0xFF = none). Must be called with interrupts disabled
+uint8_t Scheduler_find_edf(void)
+{
+    uint8_t i, best = 0xFF;
+    int16_t left, bestleft = 0;
+    bool    preempt = (_currenttask != 0xFF);
+
+    // compare remaining time until deadline to avoid overflow issues
+    if (preempt)
+        bestleft = (int16_t)(_currentdeadline - _timebase);
+
+    for (i = 0; i < _lasttask; i++)
+    {
+        if ((_activemask[TASK_WORD(i)] & ~_runningmask[TASK_WORD(i)] & TASK_BIT(i)) && ((int16_t)(SchedulingTime[i] - _timebase) <= 0))
+        {
+            left = (int16_t)(SchedulingTime[i] + Scheduler_get_deadline(i) - _timebase);
+            if (((best == 0xFF) && (preempt == false)) || (left < bestleft))
+            {
+                best = i;
+                bestleft = left;
+            }
+        }
+    }
+
+    return best;
+
+} // Scheduler_find_edf()
+
+#endif // TASKS_USE_EDF
+
+
+// execute task in scheduler slot. Returns true if a successor task was released. Must be called with
+// interrupts disabled, returns with interrupts disabled
+bool Scheduler_execute_task(uint8_t i)
+{
+    uint8_t  prevtask;
+    int16_t  prevrelease;
+    bool     released = false;
+    #if (TASKS_USE_EDF)
+        int16_t  prevdeadline;
+    #endif
+
+    // execute task
+    _runningmask[TASK_WORD(i)] |= TASK_BIT(i);              // avoid dual function call
+    prevtask = _currenttask;                                // store preempted task, see Tasks_Release()
+    prevrelease = _currentrelease;
+    _currenttask = i;
+    _currentrelease = SchedulingTime[i];
+    #if (TASKS_USE_EDF)
+        prevdeadline = _currentdeadline;
+        _currentdeadline = SchedulingTime[i] + Scheduler_get_deadline(i);
+    #endif
+    SchedulingTime[i] = _timebase + SchedulingPeriod[i];    // set time of next call
+    #if (TASKS_USE_BUDGET)
+        SchedulingStart[i] = SUPERVISION_TIME;              // start budget supervision
+        SchedulingFlags[i] &= ~TASK_FLAG_OVERRUN;
+    #endif
+
+    // re-enable interrupts
+    interrupts();
+
+    // execute function
+    SchedulingFunc[i]();
+
+    // disable interrupts
+    noInterrupts();
+
+    // re-allow function call by scheduler                     
+    _runningmask[TASK_WORD(i)] &= ~TASK_BIT(i);
+    _currenttask = prevtask;
+    _currentrelease = prevrelease;
+    #if (TASKS_USE_EDF)
+        _currentdeadline = prevdeadline;
+    #endif
+
+    #if (TASKS_USE_CHAINS)
+        // release successor as soon as all its predecessors have finished. Is executed in same tick. A successor
+        // paused by the application is not released, and a parked one stays parked
+        uint8_t j = SchedulingSucc[i];
+        if ((j != 0xFF) && ((SchedulingFlags[i] & TASK_FLAG_JOINED) == 0))
+        {
+            SchedulingFlags[i] |= TASK_FLAG_JOINED;
+            if (--SchedulingJoinLeft[j] == 0)
+            {
+                Scheduler_reset_join(j);
+                if ((SchedulingFlags[j] & TASK_FLAG_PAUSED) == 0)
+                {
+                    SchedulingFlags[j] &= ~TASK_FLAG_PARKED;
+                    SchedulingTime[j] = _timebase;
+                    _activemask[TASK_WORD(j)] |= TASK_BIT(j);
+                    released = true;
+                }
+            }
+        }
+    #endif
+
+    // if function period is 0, remove it from scheduler after execution. Successors are only
+    // parked until they are released again
+    if(SchedulingPeriod[i] == 0)
+    {
+        #if (TASKS_USE_CHAINS)
+            if (SchedulingJoin[i] != 0)
+            {
+                SchedulingFlags[i] |= TASK_FLAG_PARKED;
+                _activemask[TASK_WORD(i)] &= ~TASK_BIT(i);
+            }
+            else
+                Scheduler_remove_task(i);
+        #else
+            Scheduler_remove_task(i);
+        #endif
+    }
+
+    return released;
+
+} // Scheduler_execute_task()
+
+
+#if defined(__AVR__)
+    ISR(TIMER0_COMPA_vect)  // Timer0 interrupt is called each 1.024ms before the OVL interrupt used for millis()
+#elif defined(__SAM3X8E__)
+    void TC3_Handler(void)
 #else
     void Scheduler_dummy_handler(void) // avoid compiler error for unsupported boards
 #endif
 {
-    uint8_t i;
+    uint8_t     i, w;
+    TasksMask_t pending;
+    bool        released;
     
     // measure speed via GPIO
     #if (TASKS_MEASURE_PIN)
@@ -477,7 +1767,29 @@ void Tasks_Pause(void)
     }
     
     // increase 1ms counter    
-    _timebase++;
+    #if defined(__AVR__)
+        _timeseq++;
+        _timebase++;
+    #elif defined(__SAM3X8E__)
+        {
+            // also store start of tick for Tasks_Now(), which may be called from SysTick in between
+            PAUSE_INTERRUPTS;
+            _timeseq++;
+            _timebase++;
+            _tickmicros = micros() - (TC1->TC_CHANNEL[0].TC_CV * TASKS_TICK_US) / TC1->TC_CHANNEL[0].TC_RC;
+            RESUME_INTERRUPTS;
+        }
+    #endif
+
+    // check budget of running tasks and measure load only if used. On SAM this is done in Tasks_SysTick()
+    #if defined(__AVR__) && (TASKS_USE_BUDGET)
+        if (_budgetused)
+            Scheduler_check_budget();
+    #endif
+    #if defined(__AVR__) && (TASKS_USE_SHEDDING)
+        if (_shedhigh != 0)
+            Scheduler_measure_load();
+    #endif
 
     // no task is pending -> return immediately
     if ((int16_t)(_nexttime - _timebase) > 0) {
@@ -487,52 +1799,88 @@ void Tasks_Pause(void)
         return;
     }
 
-    // loop over scheduler slots
-    for(i = 0; i < _lasttask; i++)
+    // max. nesting depth reached -> only count tick to limit stack usage. Pending tasks are started by next tick
+    if ((_maxnesting != 0) && (_nesting >= _maxnesting)) {
+        _skippedticks++;
+        #if (TASKS_MEASURE_PIN) // measure speed via GPIO
+            CLEAR_PIN;
+        #endif
+        return;
+    }
+
+    // track nesting depth. Nested calls return in reverse order, thus no atomic access required
+    #if (TASKS_USE_SHEDDING)
+        if ((_nesting == 0) && (_shedhigh != 0))
+            _busystart = Tasks_Now();   // start of busy time for load measurement
+    #endif
+    _nesting++;
+    if (_nesting > _peaknesting)
+        _peaknesting = _nesting;
+
+    // loop over scheduler slots until no more successor tasks are released
+    do
     {
-        // disable interrupts
-        noInterrupts();
+        released = false;
 
-        // function pointer found in list, function is active and not running (arguments ordered to provide maximum speed
-        if ((SchedulingTable[i].active == true) && (SchedulingTable[i].running == false) && (SchedulingTable[i].func != NULL))
-        {
-            // function period has passed
-            if((int16_t)(SchedulingTable[i].time - _timebase) <= 0)
+        // earliest deadline first: execute due tasks until none is left or the running task is more urgent
+        #if (TASKS_USE_EDF)
+            if (_schedulingmode == TASKS_MODE_EDF)
             {
-                // execute task
-                SchedulingTable[i].running = true;                                  // avoid dual function call
-                SchedulingTable[i].time = _timebase + SchedulingTable[i].period;    // set time of next call
-                
-                // re-enable interrupts
+                noInterrupts();
+                while ((i = Scheduler_find_edf()) != 0xFF)
+                    released |= Scheduler_execute_task(i);
                 interrupts();
+                continue;
+            }
+        #endif
+
+        // loop over bitmask words of scheduler slots
+        for(w = 0; w < TASKS_MASK_WORDS(_lasttask); w++)
+        {
+            // candidates are active and not running tasks. Skip whole word if there are none
+            noInterrupts();
+            pending = _activemask[w] & ~_runningmask[w];
+            interrupts();
+
+            // loop over candidate slots within word
+            for(i = w * TASKS_MASK_BITS; pending != 0; i++, pending >>= 1)
+            {
+                if ((pending & 0x01) == 0)
+                    continue;
 
-                // execute function
-                SchedulingTable[i].func();
-                
                 // disable interrupts
                 noInterrupts();
-                
-                // re-allow function call by scheduler                     
-                SchedulingTable[i].running = false;
-                
-                // if function period is 0, remove it from scheduler after execution                     
-                if(SchedulingTable[i].period == 0)
-                {
-                    SchedulingTable[i].func = NULL;
-                }
-                
+
+                // check again, flags may have been changed by a task in the meantime (arguments ordered to provide maximum speed)
+                if ((_activemask[w] & ~_runningmask[w] & TASK_BIT(i)) && ((int16_t)(SchedulingTime[i] - _timebase) <= 0))
+                    released |= Scheduler_execute_task(i);
+            
                 // re-enable interrupts
                 interrupts();
-            } // if function period has passed
-        } // if function found
-        
-        // re-enable interrupts
-        interrupts();
+
+            } // loop over candidate slots
     
-    } // loop over scheduler slots
+        } // loop over bitmask words
+
+    } while (released);
 
     // find time for next task execution
     Scheduler_update_nexttime();
+
+    // leave nesting level. For load measurement add busy time of outermost level atomically
+    #if (TASKS_USE_SHEDDING)
+        if ((_nesting == 1) && (_shedhigh != 0))
+        {
+            PAUSE_INTERRUPTS;
+            _busytime += Tasks_Now() - _busystart;
+            _nesting--;
+            RESUME_INTERRUPTS;
+        }
+        else
+            _nesting--;
+    #else
+        _nesting--;
+    #endif
  
     // measure speed viaGPIO
     #if (TASKS_MEASURE_PIN)
@@ -51,9 +51,95 @@
 /*-----------------------------------------------------------------------------
         GLOBAL MACROS
 -----------------------------------------------------------------------------*/
-#define MAX_TASK_CNT    8   //!< Maximum number of parallel tasks
+#ifndef MAX_TASK_CNT
+    #define MAX_TASK_CNT    8   //!< Number of task slots provided by Tasks_Init() without arguments
+#endif
+#ifndef MAX_BACKGROUND_CNT
+    #define MAX_BACKGROUND_CNT  4   //!< Maximum number of background tasks, see Tasks_Add_Background()
+#endif
+
+// Optional features, all enabled by default. Each one costs RAM per task slot (see TASKS_SLOT_BYTES), i.e. 
+// unused features can be disabled to save RAM. The setting must be identical for the library and the sketch. 
+// Therefore set it here or via a compiler option for all files, e.g. -DTASKS_USE_BUDGET=0. A #define in the 
+// sketch does not reach the library, because it is compiled separately. Tasks_Init() detects a mismatch
+#ifndef TASKS_USE_BUDGET
+    #define TASKS_USE_BUDGET    1   //!< Enable execution budget supervision, see Tasks_SetBudget()
+#endif
+#ifndef TASKS_USE_GROUPS
+    #define TASKS_USE_GROUPS    1   //!< Enable task groups, see Tasks_SetGroup()
+#endif
+#ifndef TASKS_USE_CHAINS
+    #define TASKS_USE_CHAINS    1   //!< Enable task chains, see Tasks_Chain()
+#endif
+#ifndef TASKS_USE_EDF
+    #define TASKS_USE_EDF       1   //!< Enable earliest-deadline-first dispatch, see Tasks_SetMode()
+#endif
+#ifndef TASKS_USE_SHEDDING
+    #define TASKS_USE_SHEDDING  1   //!< Enable adaptive load shedding, see Tasks_SetShedding()
+#endif
+#ifndef TASKS_USE_BACKGROUND
+    #define TASKS_USE_BACKGROUND 1  //!< Enable background tasks in idle time, see Tasks_Add_Background()
+#endif
+#define TASKS_FEATURES      ((TASKS_USE_BUDGET ? 0x01 : 0) | (TASKS_USE_GROUPS ? 0x02 : 0) | (TASKS_USE_CHAINS ? 0x04 : 0) | \
+                             (TASKS_USE_EDF ? 0x08 : 0) | (TASKS_USE_SHEDDING ? 0x10 : 0) | (TASKS_USE_BACKGROUND ? 0x20 : 0))  //!< Bitmask of enabled optional features, checked by Tasks_Init()
 //#define PTR_NON_STATIC_METHOD(instance, method)    [instance](){instance.method();}    //!< Get pointer to non-static member function via lambda function, see https://stackoverflow.com/questions/53091205/how-to-use-non-static-member-functions-as-callback-in-c
 
+#define TASKS_OVERRUN_NOTIFY    0x00    //!< Action on budget overrun: only count overrun and call hook, see Tasks_SetBudget()
+#define TASKS_OVERRUN_DISABLE   0x01    //!< Action on budget overrun: additionally deactivate task after it returns, see Tasks_SetBudget()
+#define TASKS_OVERRUN_RESET     0x02    //!< Action on budget overrun: additionally reset controller, see Tasks_SetBudget()
+
+#define TASKS_MODE_INDEX        0x00    //!< Dispatch order: due tasks in order of scheduler slots (default), see Tasks_SetMode()
+#define TASKS_MODE_EDF          0x01    //!< Dispatch order: due tasks by earliest absolute deadline, see Tasks_SetMode()
+
+#if defined(__AVR__)
+    #define TASKS_TICK_US       (16384000UL / (F_CPU / 1000UL))  //!< Duration of scheduler tick in us (64 * 256 timer clocks)
+#else
+    #define TASKS_TICK_US       1000UL                          //!< Duration of scheduler tick in us
+#endif
+
+#if defined(__SAM3X8E__)
+    #define TASKS_RAM_STATE_HW  sizeof(uint32_t)    //!< Static RAM of controller specific scheduler state in bytes
+#else
+    #define TASKS_RAM_STATE_HW  0                   //!< Static RAM of controller specific scheduler state in bytes
+#endif
+
+#define TASKS_MASK_BITS         (8 * sizeof(TasksMask_t))                           //!< Number of task flags per bitmask word
+#define TASKS_MASK_WORDS(cnt)   (((cnt) + TASKS_MASK_BITS - 1) / TASKS_MASK_BITS)   //!< Number of bitmask words for <tt>cnt</tt> tasks
+
+/**
+    \brief      Size of one task slot in bytes, excl. the 'active' and 'running' bits
+    \details    Each slot holds the function, period and next call time. Enabled optional features add their 
+                data, see TASKS_USE_xxx.
+*/
+#define TASKS_SLOT_BYTES        (sizeof(Task) + 2 * sizeof(int16_t) + \
+                                 (TASKS_USE_EDF ? sizeof(int16_t) : 0) + \
+                                 (TASKS_USE_SHEDDING ? 2 * sizeof(int16_t) + sizeof(uint8_t) : 0) + \
+                                 (TASKS_USE_BUDGET ? 2 * sizeof(int16_t) + sizeof(uint8_t) : 0) + \
+                                 ((TASKS_USE_BUDGET || TASKS_USE_CHAINS) ? sizeof(uint8_t) : 0) + \
+                                 (TASKS_USE_GROUPS ? sizeof(uint8_t) : 0) + \
+                                 (TASKS_USE_CHAINS ? 3 * sizeof(uint8_t) : 0))
+
+/**
+    \brief      Size of the task table storage for <tt>cnt</tt> tasks in units of <tt>TasksMask_t</tt>
+    \details    Per task the storage holds one slot (see TASKS_SLOT_BYTES) plus one 'active' and one 'running' 
+                bit. Use this to define the buffer passed to Tasks_Init(TasksMask_t*, uint8_t).
+*/
+#define TASKS_BUFFER_WORDS(cnt) ((2 * TASKS_MASK_WORDS(cnt) * sizeof(TasksMask_t) + (cnt) * TASKS_SLOT_BYTES + \
+                                  sizeof(TasksMask_t) - 1) / sizeof(TasksMask_t))
+
+#define TASKS_RAM_STATE         (sizeof(void*) + sizeof(bool) + 4 * sizeof(int16_t) + 7 * sizeof(uint8_t) + TASKS_RAM_STATE_HW + \
+                                 (TASKS_USE_BUDGET ? sizeof(void*) + sizeof(bool) : 0) + \
+                                 (TASKS_USE_EDF ? sizeof(int16_t) + sizeof(uint8_t) : 0) + \
+                                 (TASKS_USE_SHEDDING ? 5 * sizeof(uint8_t) + 2 * sizeof(uint32_t) : 0) + \
+                                 (TASKS_USE_BACKGROUND ? MAX_BACKGROUND_CNT * (sizeof(TaskStep) + sizeof(int16_t)) + sizeof(uint8_t) : 0))    //!< Static RAM of scheduler state excl. task table in bytes
+
+/**
+    \brief      Static RAM used by the scheduler for <tt>cnt</tt> tasks in bytes
+    \details    Compile-time constant, e.g. for <tt>static_assert()</tt> or printing via <tt>Serial</tt>.
+                Consists of the task table storage (see TASKS_BUFFER_WORDS()) and the global scheduler state.
+*/
+#define TASKS_RAM_USAGE(cnt)    (TASKS_BUFFER_WORDS(cnt) * sizeof(TasksMask_t) + TASKS_RAM_STATE)
+
 
 /*-----------------------------------------------------------------------------
         GLOBAL CLASS
@@ -61,16 +147,75 @@
 
 typedef void (*Task)(void); //!< Example prototype for a function than can be executed as a task
 
+typedef bool (*TaskStep)(void); //!< Example prototype for a background task step, see Tasks_Add_Background()
+
+typedef void (*TaskOverrunHook)(Task func); //!< Prototype of function called when a task exceeds its budget, see Tasks_SetOverrunHook()
+
+#if defined(__SAM3X8E__)
+    typedef uint32_t TasksMask_t;   //!< Bitmask word holding one flag per task (native word size of controller)
+#else
+    typedef uint8_t  TasksMask_t;   //!< Bitmask word holding one flag per task (native word size of controller)
+#endif
+
 
 
 /**
     \brief      Initialize timer and reset the tasks scheduler at first call.
     \details    This function initializes the related timer and clears the task scheduler at first call.
+                <br>The task table is stored in a library buffer with <tt>MAX_TASK_CNT</tt> slots. To use a different 
+                number of slots without editing the library, use Tasks_Init<cnt>() or Tasks_Init(TasksMask_t*, uint8_t).
+                The library buffer is only linked if this variant is called.
+                <br>One variant of Tasks_Init() must be called before tasks are added, see Tasks_Add().
                 <br><br>Used HW blocks:
                 <br>- Arduino ATMega: TIMER0_COMPA_vect
                 <br>- Arduino SAM: TC3
+    \return     true in case of success
 */
-void Tasks_Init(void);
+bool Tasks_Init(void);
+
+
+
+/**
+    \brief      Initialize timer and reset the tasks scheduler using application storage.
+    \details    Same as Tasks_Init(), but the task table is stored in the buffer provided by the application.
+                This allows to use any number of task slots, e.g.
+                <br><tt>TasksMask_t myTasks[TASKS_BUFFER_WORDS(3)];</tt>
+                <br><tt>Tasks_Init(myTasks, 3);</tt>
+                <br>The scheduler is only cleared when the buffer or the number of slots differs from the previous 
+                call, i.e. repeated calls with the same arguments keep the registered tasks.
+                <br>The size of the buffer depends on the optional features, see TASKS_USE_xxx. Therefore the 
+                features enabled where the buffer is defined are passed via the default argument and compared 
+                to those of the library. On a mismatch the buffer is rejected.
+                <br><br>Used HW blocks:
+                <br>- Arduino ATMega: TIMER0_COMPA_vect
+                <br>- Arduino SAM: TC3
+    \param[in]  buffer  Storage for task table with at least <tt>TASKS_BUFFER_WORDS(cnt)</tt> elements. 
+                        Must stay valid as long as the scheduler is used.
+    \param[in]  cnt     Number of task slots (1 to 255)
+    \param[in]  features    Optional features used for sizing the buffer (do not pass, see TASKS_FEATURES)
+    \return     true in case of success, 
+                false in case of failure (no buffer, no slots, or different optional features in sketch and library)
+*/
+bool Tasks_Init(TasksMask_t *buffer, uint8_t cnt, uint8_t features = TASKS_FEATURES);
+
+
+
+/**
+    \brief      Initialize timer and reset the tasks scheduler with a given number of task slots.
+    \details    Same as Tasks_Init(TasksMask_t*, uint8_t) using a statically allocated buffer for <tt>CNT</tt> 
+                tasks, e.g. <tt>Tasks_Init<3>();</tt>
+                <br><br>Used HW blocks:
+                <br>- Arduino ATMega: TIMER0_COMPA_vect
+                <br>- Arduino SAM: TC3
+    \tparam     CNT     Number of task slots (1 to 255)
+    \return     true in case of success, 
+                false in case of failure (different optional features in sketch and library)
+*/
+template <uint8_t CNT> inline bool Tasks_Init(void)
+    {
+        static TasksMask_t buffer[TASKS_BUFFER_WORDS(CNT)];
+        return Tasks_Init(buffer, CNT);
+    }
 
 
 
@@ -102,8 +247,8 @@ void Tasks_Clear(void);
     \param[in]  period  Execution period of the task in ms (0 to 32767; 0 = task only executes once) 
     \param[in]  delay   Delay until first execution of task in ms (0 to 32767)
     \return     true in case of success,
-                false in case of failure (max. number of tasks reached, or duplicate function)
-    \note       The maximum number of tasks is defined as <tt>MAX_TASK_CNT</tt> in file <tt>Tasks.h</tt>
+                false in case of failure (function is NULL, Tasks_Init() not called, or max. number of tasks reached)
+    \note       The maximum number of tasks is set by Tasks_Init().
 */
 bool Tasks_Add(Task func, int16_t period, int16_t delay = 0);
 
@@ -203,6 +348,460 @@ inline bool Tasks_Pause_Task(Task func)
 
 
 
+#if (TASKS_USE_BACKGROUND)
+
+/**
+    \brief      Add a background task
+    \details    Background tasks are not executed by the scheduler interrupt, but by Tasks_Idle() from the main 
+                loop, and only while no scheduled task is running or due within the next 1ms timer tick. 
+                This allows to use otherwise idle CPU time for work which is not time critical (e.g. checksums, 
+                log compression, flash wear leveling) without delaying the scheduled tasks.
+                <br>The step function performs a small part of the work per call and is called repeatedly within
+                the given budget per time slice. It returns 'true' as long as work is pending and 'false' when 
+                finished, which removes the background task automatically.
+                <br>Adding a function a second time overwrites the budget of the existing background task.
+                <br>Not available if <tt>TASKS_USE_BACKGROUND</tt> is set to 0.
+    \param[in]  step    Function to be executed.<br>The function prototype should be similar to this:
+                        "bool userFunction(void)"
+    \param[in]  budget  Max. time per time slice in ms (0 to 32767; 0 = one call per time slice)
+    \return     true in case of success,
+                false in case of failure (max. number of background tasks reached)
+    \note       The maximum number of background tasks is defined as <tt>MAX_BACKGROUND_CNT</tt> in file <tt>Tasks.h</tt>
+*/
+bool Tasks_Add_Background(TaskStep step, int16_t budget);
+
+
+
+/**
+    \brief      Remove a background task
+    \details    Remove the specified background task before it has finished.
+                <br>Not available if <tt>TASKS_USE_BACKGROUND</tt> is set to 0.
+    \param[in]  step    Function to be removed
+    \return     true in case of success, 
+                false in case of failure (e.g. function not in not in background task list)
+*/
+bool Tasks_Remove_Background(TaskStep step);
+
+
+
+/**
+    \brief      Execute background tasks in idle time
+    \details    Call this function from loop(). It executes one time slice of the next background task 
+                (round robin), see Tasks_Add_Background(). The slice ends when its budget is used up, when a 
+                scheduled task becomes due within the next 1ms timer tick or when the step function signals that
+                it has finished.
+                <br>Not available if <tt>TASKS_USE_BACKGROUND</tt> is set to 0.
+    \return     true if a background task was pending, false if there is no background task
+*/
+bool Tasks_Idle(void);
+
+#endif // TASKS_USE_BACKGROUND
+
+
+
+#if (TASKS_USE_GROUPS)
+
+/**
+    \brief      Assign a task to one or more groups
+    \details    Groups allow to pause, resume, delay or remove several tasks at once, e.g. when switching 
+                between operating modes, see Tasks_SetState_Group(). Each bit of the group argument stands for 
+                one group, i.e. up to 8 groups are supported and a task can belong to several of them.
+                <br>Tasks_Add() resets the group membership to 0 (no group).
+                <br>Not available if <tt>TASKS_USE_GROUPS</tt> is set to 0.
+                <br>For non-static member function use address from PTR_NON_STATIC_METHOD() macro. 
+    \param[in]  func    Function to be assigned
+    \param[in]  group   Bitmask of groups (0 = no group)
+    \return     true in case of success, 
+                false in case of failure (e.g. function not in not in scheduler table)
+*/
+bool Tasks_SetGroup(Task func, uint8_t group);
+
+
+
+/**
+    \brief      Enable or disable the execution of all tasks of one or more groups
+    \details    Same as Tasks_SetState() for all tasks belonging to at least one of the given groups. 
+                All tasks are changed within a single interrupt lock, i.e. the scheduler never executes a 
+                partly switched set of tasks, and the time of the next task call is only updated once.
+                <br><br>Used HW blocks:
+                <br>- Arduino ATMega: TIMER0_COMPA_vect
+                <br>- Arduino SAM: TC3
+    \param[in]  group   Bitmask of groups, see Tasks_SetGroup()
+    \param[in]  state   New function state (false=pause, true=resume)
+    \return     number of changed tasks
+*/
+uint8_t Tasks_SetState_Group(uint8_t group, bool state);
+
+
+
+/**
+    \brief      Activate all tasks of one or more groups
+    \details    This is a simple inlined function setting the 'state' argument for Tasks_SetState_Group().
+    \param[in]  group   Bitmask of groups, see Tasks_SetGroup()
+    \return     number of activated tasks
+*/
+inline uint8_t Tasks_Start_Group(uint8_t group)
+    {
+        return Tasks_SetState_Group(group, true);
+    }
+
+
+
+/**
+    \brief      Deactivate all tasks of one or more groups
+    \details    This is a simple inlined function setting the 'state' argument for Tasks_SetState_Group().
+    \param[in]  group   Bitmask of groups, see Tasks_SetGroup()
+    \return     number of deactivated tasks
+*/
+inline uint8_t Tasks_Pause_Group(uint8_t group)
+    {
+        return Tasks_SetState_Group(group, false);
+    }
+
+
+
+/**
+    \brief      Delay execution of all tasks of one or more groups
+    \details    Same as Tasks_Delay() for all tasks belonging to at least one of the given groups, 
+                applied within a single interrupt lock.
+                <br><br>Used HW blocks:
+                <br>- Arduino ATMega: TIMER0_COMPA_vect
+                <br>- Arduino SAM: TC3
+    \param[in]  group   Bitmask of groups, see Tasks_SetGroup()
+    \param[in]  delay   Delay in ms (0 to 32767)
+    \return     number of delayed tasks
+*/
+uint8_t Tasks_Delay_Group(uint8_t group, int16_t delay);
+
+
+
+/**
+    \brief      Remove all tasks of one or more groups from the task scheduler
+    \details    Same as Tasks_Remove() for all tasks belonging to at least one of the given groups, 
+                applied within a single interrupt lock.
+                <br><br>Used HW blocks:
+                <br>- Arduino ATMega: TIMER0_COMPA_vect
+                <br>- Arduino SAM: TC3
+    \param[in]  group   Bitmask of groups, see Tasks_SetGroup()
+    \return     number of removed tasks
+*/
+uint8_t Tasks_Remove_Group(uint8_t group);
+
+#endif // TASKS_USE_GROUPS
+
+
+
+#if (TASKS_USE_CHAINS)
+
+/**
+    \brief      Release a task as soon as another task has finished
+    \details    Builds pipelines of tasks, e.g. acquire -> filter -> publish. When the predecessor task has 
+                finished, the successor becomes due at once and is still executed within the same scheduler 
+                tick, i.e. without waiting for its own period.
+                <br>Several predecessors may be chained to the same successor (fan-in join). In this case the 
+                successor is released once all its predecessors have finished.
+                <br>A successor added with a period of 0 is only executed when it is released and is not removed 
+                after execution. A successor with a period >0 is additionally executed periodically.
+                <br>Each task can have one successor. Cyclic chains are rejected.
+                <br>Not available if <tt>TASKS_USE_CHAINS</tt> is set to 0.
+                <br>For non-static member function use address from PTR_NON_STATIC_METHOD() macro. 
+                <br><br>Used HW blocks:
+                <br>- Arduino ATMega: TIMER0_COMPA_vect
+                <br>- Arduino SAM: TC3
+    \param[in]  pred    Predecessor task
+    \param[in]  succ    Successor task (NULL = remove existing link)
+    \return     true in case of success, 
+                false in case of failure (e.g. function not in not in scheduler table, or cyclic chain)
+*/
+bool Tasks_Chain(Task pred, Task succ);
+
+#endif // TASKS_USE_CHAINS
+
+
+
+#if (TASKS_USE_EDF)
+
+/**
+    \brief      Set the relative deadline of a task
+    \details    The deadline is the time after the release of a task at which its execution should be finished.
+                It is only used for ordering in mode TASKS_MODE_EDF, see Tasks_SetMode(). A deadline of 0
+                corresponds to the period of the task, i.e. a task should finish before its next release. One-shot 
+                tasks and released successors without own deadline are treated as due immediately. 
+                <br>The deadline is reset by Tasks_Add().
+                <br>For non-static member function use address from PTR_NON_STATIC_METHOD() macro. 
+    \param[in]  func        Function to be modified
+    \param[in]  deadline    Relative deadline in ms (1 to 32767; 0 = period of task)
+    \return     true in case of success, 
+                false in case of failure (e.g. function not in not in scheduler table)
+*/
+bool Tasks_SetDeadline(Task func, int16_t deadline);
+
+
+
+/**
+    \brief      Set the dispatch order of the task scheduler
+    \details    In mode TASKS_MODE_INDEX (default) the due tasks of a scheduler tick are executed in the order 
+                of the scheduler slots, i.e. in the order they were added.
+                <br>In mode TASKS_MODE_EDF (earliest deadline first) the due task with the earliest absolute 
+                deadline, i.e. release time plus relative deadline (see Tasks_SetDeadline()), is executed first.
+                On the Arduino ATMega a running task is then only preempted by a due task with an earlier 
+                absolute deadline. This allows for a higher CPU load without missing deadlines, at the cost of 
+                a search over all tasks per execution.
+                <br>Not available if <tt>TASKS_USE_EDF</tt> is set to 0.
+                <br><br>Used HW blocks:
+                <br>- Arduino ATMega: TIMER0_COMPA_vect
+                <br>- Arduino SAM: TC3
+    \param[in]  mode    Dispatch order TASKS_MODE_INDEX or TASKS_MODE_EDF
+*/
+void Tasks_SetMode(uint8_t mode);
+
+#endif // TASKS_USE_EDF
+
+
+
+#if (TASKS_USE_SHEDDING)
+
+/**
+    \brief      Allow the scheduler to adapt the period of a task to the CPU load
+    \details    The task is executed with the min. period while the CPU load is low. When the load exceeds the 
+                threshold set via Tasks_SetShedding() and the criticality of the task is below the given limit, 
+                its period is doubled after each load measurement up to the max. period. When the load falls 
+                below the lower threshold, the period is halved again down to the min. period. Tasks without 
+                period range keep their period.
+                <br>The range is reset by Tasks_Add(). One-shot tasks are not supported.
+                <br>For non-static member function use address from PTR_NON_STATIC_METHOD() macro. 
+    \param[in]  func        Function to be modified
+    \param[in]  minperiod   Period at low load in ms (1 to 32767)
+    \param[in]  maxperiod   Max. period under overload in ms (minperiod to 32767)
+    \param[in]  criticality Criticality of task (higher = more critical), see Tasks_SetShedding()
+    \return     true in case of success, 
+                false in case of failure (e.g. function not in not in scheduler table, or invalid range)
+*/
+bool Tasks_SetPeriodRange(Task func, int16_t minperiod, int16_t maxperiod, uint8_t criticality);
+
+
+
+/**
+    \brief      Set the thresholds for load shedding
+    \details    The CPU load is measured as share of time in which a task is running, see Tasks_GetLoad(). At a load of <tt>high</tt> or above, the periods of tasks with a criticality 
+                below <tt>criticality</tt> are stretched, at a load of <tt>low</tt> or below they are restored, 
+                see Tasks_SetPeriodRange(). This keeps the execution of critical tasks intact under overload.
+                <br>On the Arduino SAM the load is measured by the SysTick interrupt, i.e. the application must 
+                call Tasks_SysTick() from <tt>sysTickHook()</tt>.
+                <br>Not available if <tt>TASKS_USE_SHEDDING</tt> is set to 0.
+                <br><br>Used HW blocks:
+                <br>- Arduino ATMega: TIMER0_COMPA_vect
+                <br>- Arduino SAM: TC3, SysTick
+    \param[in]  high        Load in % to start stretching periods (0 = no load shedding and load measurement, 
+                            default; >100 = only measure load)
+    \param[in]  low         Load in % to start restoring periods (below <tt>high</tt>)
+    \param[in]  criticality Tasks with a lower criticality are stretched
+*/
+void Tasks_SetShedding(uint8_t high, uint8_t low, uint8_t criticality);
+
+
+
+/**
+    \brief      Get the CPU load of the task scheduler
+    \details    Share of time within the last 100 scheduler ticks in which a task was running. The busy time is 
+                measured via Tasks_Now() around the task executions, i.e. short tasks are also accounted. Is 
+                only measured while the scheduler is running and load shedding is enabled via Tasks_SetShedding().
+    \return     CPU load in %
+*/
+uint8_t Tasks_GetLoad(void);
+
+#endif // TASKS_USE_SHEDDING
+
+
+
+#if (TASKS_USE_BUDGET)
+
+/**
+    \brief      Set the execution budget of a task
+    \details    The scheduler checks every 1ms whether a currently running task has exceeded its budget. 
+                In this case the overrun is counted (see Tasks_GetOverruns()), the hook set via 
+                Tasks_SetOverrunHook() is called and the selected action is taken. Each overrun is only reported
+                once per task execution.
+                <br>This turns a hanging task, which blocks all tasks started before it, into a detected fault.
+                On the Arduino ATMega the check is done by the nested scheduler interrupt. On the Arduino SAM 
+                it is done by the SysTick interrupt, i.e. the application must call Tasks_SysTick() from 
+                <tt>sysTickHook()</tt>.
+                <br>Not available if <tt>TASKS_USE_BUDGET</tt> is set to 0.
+                <br>For non-static member function use address from PTR_NON_STATIC_METHOD() macro. 
+                <br><br>Used HW blocks:
+                <br>- Arduino ATMega: TIMER0_COMPA_vect
+                <br>- Arduino SAM: TC3, SysTick
+    \param[in]  func    Function to be supervised
+    \param[in]  budget  Maximum execution time in ms (1 to 32767; 0 = no supervision)
+    \param[in]  action  Action on overrun:
+                        <br>- TASKS_OVERRUN_NOTIFY: only count overrun and call hook
+                        <br>- TASKS_OVERRUN_DISABLE: deactivate task, i.e. it is not called again after it returns
+                        <br>- TASKS_OVERRUN_RESET: reset controller (ATMega via watchdog, SAM via NVIC_SystemReset() 
+                        because the watchdog cannot be re-enabled there)
+    \return     true in case of success, 
+                false in case of failure (e.g. function not in not in scheduler table)
+*/
+bool Tasks_SetBudget(Task func, int16_t budget, uint8_t action = TASKS_OVERRUN_NOTIFY);
+
+
+
+/**
+    \brief      Get number of budget overruns of a task
+    \details    Number of task executions which exceeded the budget set via Tasks_SetBudget(). 
+                The counter saturates at 255 and is reset by Tasks_SetBudget() and Tasks_Add().
+                <br>For non-static member function use address from PTR_NON_STATIC_METHOD() macro. 
+    \param[in]  func    Function to be checked
+    \return     number of overruns (0 if function not in scheduler table)
+*/
+uint8_t Tasks_GetOverruns(Task func);
+
+
+
+/**
+    \brief      Set function to be called on budget overrun
+    \details    The hook is called from interrupt context when a task exceeds its budget, see Tasks_SetBudget(). 
+                On the Arduino ATMega interrupts are disabled, on the Arduino SAM it is called from the SysTick 
+                interrupt, i.e. only interrupts of higher priority can occur. It receives the overrunning task 
+                and must be kept very short, e.g. set a flag or an output pin.
+    \param[in]  hook    Function to be called (NULL = no hook)
+*/
+void Tasks_SetOverrunHook(TaskOverrunHook hook);
+
+#endif // TASKS_USE_BUDGET
+
+
+
+/**
+    \brief      Supervise budgets and measure load from the SysTick interrupt
+    \details    On the Arduino SAM the scheduler interrupt does not nest, i.e. it cannot detect a hanging task. 
+                Budget supervision (see Tasks_SetBudget()) and load measurement (see Tasks_SetShedding()) are 
+                therefore done by the 1ms SysTick interrupt. The library does not define the <tt>sysTickHook()</tt> 
+                of the Arduino SAM core, to allow other libraries or the application to use it. Instead, call 
+                this function from the hook of the application, e.g.
+                <br><tt>int sysTickHook(void) { Tasks_SysTick(); return 0; }</tt>
+                <br>On the Arduino ATMega this is done by the scheduler interrupt, and this function does nothing.
+                <br><br>Used HW blocks:
+                <br>- Arduino SAM: SysTick
+*/
+void Tasks_SysTick(void);
+
+
+
+/**
+    \brief      Limit the nesting depth of the task scheduler
+    \details    On the Arduino ATMega the scheduler interrupt is reentrant, i.e. under overload it nests again and 
+                again and each level uses stack for a complete interrupt frame plus the task. When the given depth 
+                is reached, further scheduler ticks only advance the time base and do not start tasks. Pending 
+                tasks are started after the running tasks have finished. The number of these ticks is 
+                available via Tasks_GetSkippedTicks().
+                <br>On the Arduino SAM the scheduler interrupt does not nest, i.e. the depth is always 1.
+    \param[in]  depth   Max. number of nested task executions (0 = unlimited, default)
+*/
+void Tasks_SetMaxNesting(uint8_t depth);
+
+
+
+/**
+    \brief      Get the max. nesting depth of the task scheduler so far
+    \details    Returns the highest number of simultaneously running (i.e. preempted plus current) tasks.
+                Use this to check the setting of Tasks_SetMaxNesting() under load.
+    \return     max. nesting depth
+*/
+uint8_t Tasks_GetPeakNesting(void);
+
+
+
+/**
+    \brief      Get the number of skipped scheduler ticks
+    \details    Number of scheduler ticks which did not start tasks because the max. nesting depth set via 
+                Tasks_SetMaxNesting() was reached. The counter wraps around after 65535.
+    \return     number of skipped ticks
+*/
+uint16_t Tasks_GetSkippedTicks(void);
+
+
+
+/**
+    \brief      Fill the unused RAM between heap and stack with a pattern
+    \details    Call once e.g. at the beginning of setup(). Afterwards Tasks_GetStackFree() returns the amount of
+                RAM which has never been used by the stack (or heap), i.e. the remaining reserve for nested tasks.
+                <br>Interrupts are only paused for short chunks, i.e. millis() and serial communication keep 
+                running even if the area is large.
+*/
+void Tasks_PaintStack(void);
+
+
+
+/**
+    \brief      Get stack high-water mark
+    \details    Returns the number of bytes between heap and stack which still contain the pattern written by 
+                Tasks_PaintStack(), i.e. which have never been used since painting.
+    \return     number of unused bytes (0 if Tasks_PaintStack() was not called)
+*/
+size_t Tasks_GetStackFree(void);
+
+
+
+/**
+    \brief      Get high-resolution timestamp
+    \details    Combines the 1ms counter of the scheduler with the hardware counter of the scheduler timer.
+                The timestamp is a fixed-point number: the upper 16 bits are scheduler ticks (1.024ms on 
+                Arduino ATMega, 1ms on Arduino SAM), the lower 16 bits the fraction of the current tick 
+                (resolution 4us on ATMega and 1us on SAM). It wraps around after 65536 ticks, i.e. use 
+                differences only.
+                <br>Reading does not disable interrupts: a sequence counter updated by the scheduler interrupt 
+                detects concurrent updates and the read is repeated. On the Arduino ATMega it is much faster 
+                than micros().
+                <br>On the Arduino SAM the scheduler interrupt does not nest, i.e. the 1ms counter stands still 
+                while a task runs. There the time since the last counted tick is taken from micros(), which 
+                keeps the timestamp monotonic also within tasks running for several ticks.
+                <br>The timestamp only advances while the scheduler is running, see Tasks_Start().
+                <br><br>Used HW blocks:
+                <br>- Arduino ATMega: TCNT0, OCR0A
+                <br>- Arduino SAM: TC3, SysTick
+    \return     timestamp in 1/65536 scheduler ticks
+*/
+uint32_t Tasks_Now(void);
+
+
+
+/**
+    \brief      Get release time of the currently executing task
+    \details    Returns the time at which the scheduler should have started the currently executing task, 
+                in the same format as Tasks_Now(). Together with Tasks_Now() this allows a task to measure its 
+                own release latency or response time at almost no cost, see Tasks_Latency().
+    \return     release time of current task (0 if called outside of a task)
+*/
+uint32_t Tasks_Release(void);
+
+
+
+/**
+    \brief      Get time since release of the currently executing task
+    \details    This is a simple inlined function returning Tasks_Now() - Tasks_Release(). 
+                Use Tasks_ToMicros() to convert the result.
+    \return     time since release in 1/65536 scheduler ticks
+*/
+inline uint32_t Tasks_Latency(void)
+    {
+        return Tasks_Now() - Tasks_Release();
+    }
+
+
+
+/**
+    \brief      Convert a time difference from Tasks_Now() to microseconds
+    \details    Scheduler ticks are 1.024ms (at 16MHz) on Arduino ATMega and 1ms on Arduino SAM.
+    \param[in]  time    Time difference in 1/65536 scheduler ticks
+    \return     time difference in us
+*/
+inline uint32_t Tasks_ToMicros(uint32_t time)
+    {
+        return (time >> 16) * TASKS_TICK_US + (((time & 0xFFFF) * TASKS_TICK_US) >> 16);
+    }
+
+
+
 /**
     \brief      Start the task scheduler
     \details    Resume execution of the scheduler. All active tasks are resumed. 